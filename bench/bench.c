@@ -0,0 +1,180 @@
+/*
+ * Benchmarks for the hot paths of the emulator.
+ * Microbenchmarks run on synthetic workloads, end to end frames/sec is measured on every rom given on the command line.
+ * Results are printed as JSON so throughput can be tracked per commit.
+ *
+ * Usage: nes_bench [--frames n] [--out path] [rom ...]
+ * */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bus.h"
+#include "cartridge.h"
+#include "cpu.h"
+
+#define MICRO_ITERATIONS 20000000
+
+static Bus bus;
+static volatile uint64_t sink;  // Keeps the compiler from optimizing the benchmark loops away
+
+static double Seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void WriteResult(FILE *out, bool *first, const char *name, uint64_t operations, double seconds) {
+    fprintf(out, "%s\n    {\"name\": \"%s\", \"operations\": %llu, \"seconds\": %.6f, \"ns_per_op\": %.3f, \"ops_per_sec\": %.0f}",
+            *first ? "" : ",", name, (unsigned long long)operations, seconds, seconds * 1e9 / operations, operations / seconds);
+    *first = false;
+}
+
+// Fill memory with pseudo random bytes so CpuStep dispatches across every OpcodeMatrix slot
+static void FillRandom(Bus *bus) {
+    uint32_t seed = 0x2A03;
+    for (size_t i = 0; i < sizeof(bus->ram); i++) {
+        seed = seed * 1664525 + 1013904223;
+        bus->ram[i] = seed >> 24;
+    }
+}
+
+static double BenchCpuStep() {
+    BusInit(&bus);
+    FillRandom(&bus);
+    bus.cpu.registers.ProgramCounter = 0x8000;
+
+    double start = Seconds();
+    for (int i = 0; i < MICRO_ITERATIONS; i++) {
+        CpuStep(&bus.cpu);
+    }
+    double elapsed = Seconds() - start;
+    sink = bus.cpu.cycles;
+    return elapsed;
+}
+
+static double BenchBusRead() {
+    BusInit(&bus);
+    FillRandom(&bus);
+
+    uint64_t sum = 0;
+    double start = Seconds();
+    for (int i = 0; i < MICRO_ITERATIONS; i++) {
+        sum += BusRead(&bus, (uint16_t)(i * 7));
+    }
+    double elapsed = Seconds() - start;
+    sink = sum;
+    return elapsed;
+}
+
+static double BenchBusWrite() {
+    BusInit(&bus);
+
+    double start = Seconds();
+    for (int i = 0; i < MICRO_ITERATIONS; i++) {
+        BusWrite(&bus, (uint16_t)(i * 7), (uint8_t)i);
+    }
+    double elapsed = Seconds() - start;
+    sink = bus.ram[0x1234];
+    return elapsed;
+}
+
+// Opcodes that only update registers and flags, one iteration runs 8 of them
+static double BenchFlags() {
+    BusInit(&bus);
+    CPU *cpu = &bus.cpu;
+
+    double start = Seconds();
+    for (int i = 0; i < MICRO_ITERATIONS / 8; i++) {
+        OpINX(cpu);
+        OpTXA(cpu);
+        OpTAY(cpu);
+        OpDEY(cpu);
+        OpSEC(cpu);
+        OpCLC(cpu);
+        OpTYA(cpu);
+        OpDEX(cpu);
+    }
+    double elapsed = Seconds() - start;
+    sink = cpu->registers.Flag;
+    return elapsed;
+}
+
+// Frames/sec for a rom, returns a negative value if it could not be loaded
+static double BenchRom(const char *path, long frames) {
+    BusInit(&bus);
+    if (!CartridgeLoad(&bus, path)) {
+        return -1;
+    }
+    CpuReset(&bus.cpu);
+
+    double start = Seconds();
+    for (long frame = 0; frame < frames; frame++) {
+        BusRunFrame(&bus);
+    }
+    return frames / (Seconds() - start);
+}
+
+int main(int argc, char **argv) {
+    const char *out_path = NULL;
+    long frames = 600;
+    const char **roms = (const char **)malloc(argc * sizeof(const char *));
+    int rom_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (argv[i][0] != '-') {
+            roms[rom_count++] = argv[i];
+        } else {
+            fprintf(stderr, "Usage: nes_bench [--frames n] [--out path] [rom ...]\n");
+            return 2;
+        }
+    }
+    if (frames <= 0) {
+        frames = 1;
+    }
+
+    FILE *out = stdout;
+    if (out_path != NULL) {
+        out = fopen(out_path, "w");
+        if (out == NULL) {
+            fprintf(stderr, "Could not open %s\n", out_path);
+            return 1;
+        }
+    }
+
+    bool first = true;
+    fprintf(out, "{\n  \"micro\": [");
+    WriteResult(out, &first, "cpu_step_dispatch", MICRO_ITERATIONS, BenchCpuStep());
+    WriteResult(out, &first, "bus_read", MICRO_ITERATIONS, BenchBusRead());
+    WriteResult(out, &first, "bus_write", MICRO_ITERATIONS, BenchBusWrite());
+    WriteResult(out, &first, "flags", MICRO_ITERATIONS / 8 * 8, BenchFlags());
+
+    fprintf(out, "\n  ],\n  \"roms\": [");
+    int failed = 0;
+    first = true;
+    for (int i = 0; i < rom_count; i++) {
+        double fps = BenchRom(roms[i], frames);
+        if (fps < 0) {
+            fprintf(stderr, "Could not load %s (only iNES mapper 0 is supported)\n", roms[i]);
+            failed++;
+            continue;
+        }
+        // Only the CPU is emulated so far, fps does not include PPU or APU work yet
+        fprintf(out, "%s\n    {\"rom\": \"%s\", \"frames\": %ld, \"fps\": %.2f, \"emulated\": [\"cpu\"], \"unimplemented_instructions\": %llu}",
+                first ? "" : ",", roms[i], frames, fps, (unsigned long long)bus.cpu.unimplemented);
+        first = false;
+    }
+    fprintf(out, "\n  ]\n}\n");
+
+    if (out != stdout) {
+        fclose(out);
+    }
+    free(roms);
+    return failed > 0 ? 1 : 0;
+}
@@ -3,10 +3,32 @@
  * The main purpose for the bus will be to read and write.
  * */
 
+#include <string.h>
 #include "bus.h"
+#include "profiler.h"
+
+// Clear memory and connect the devices to the bus
+void BusInit(Bus *bus) {
+    memset(bus->ram, 0, sizeof(bus->ram));
+    CpuInit(&bus->cpu);
+    CpuConnectToBus(&bus->cpu, bus);
+}
+
+// Run the CPU until it has used up one frame worth of cycles
+void BusRunFrame(Bus *bus) {
+    uint64_t frame_end = bus->cpu.cycles + CPU_CYCLES_PER_FRAME;
+
+    PROFILE_BEGIN(ProfileCpu);
+    while (bus->cpu.cycles < frame_end) {
+        CpuStep(&bus->cpu);
+    }
+    PROFILE_END(ProfileCpu);
+    PROFILE_END_FRAME();
+}
 
 // Write a byte in a specific address to the bus
 void BusWrite(Bus *bus, uint16_t address, uint8_t value) {
+    PROFILE_BUS_WRITE(address);
     // address >= 0x0000 && address <= 0xffff
     if (address < sizeof(bus->ram)) {
         bus->ram[address] = value;
@@ -15,6 +37,7 @@ void BusWrite(Bus *bus, uint16_t address, uint8_t value) {
 
 // Read a byte from the bus
 uint8_t BusRead(Bus *bus, uint16_t address) {
+    PROFILE_BUS_READ(address);
     // address >= 0x0000 && address <= 0xffff
     if (address < sizeof(bus->ram)) {
         return bus->ram[address];
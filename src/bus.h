@@ -10,12 +10,17 @@
 #include <stdint.h>
 #include "cpu.h"
 
+// NTSC runs 29780.5 CPU cycles per frame
+#define CPU_CYCLES_PER_FRAME 29781
+
 struct Bus {
     // Devices connected to the bus
     CPU cpu;
     uint8_t ram[1024 * 64];  // 64kb == 65536 bytes
-}
+};
 
+void BusInit(Bus *bus);     // Clear memory and connect the devices
+void BusRunFrame(Bus *bus);     // Run every device for one frame
 void BusWrite(Bus *bus, uint16_t address, uint8_t value);
 uint8_t BusRead(Bus *bus, uint16_t address);
 
@@ -0,0 +1,49 @@
+/*
+ * The cartridge holds the program rom of the game.
+ * Roms are stored in the iNES format, a 16 byte header followed by the program (PRG) and character (CHR) rom.
+ * */
+
+#include <stdio.h>
+#include <string.h>
+#include "cartridge.h"
+
+#define PRG_BANK_SIZE (1024 * 16)    // 16kb per PRG rom bank
+
+// Load an iNES rom into the bus. Only mapper 0 (NROM) is supported for now
+bool CartridgeLoad(Bus *bus, const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+
+    uint8_t header[16];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) || memcmp(header, "NES\x1A", 4) != 0) {
+        fclose(file);
+        return false;
+    }
+
+    uint8_t prg_banks = header[4];
+    uint8_t mapper = (header[7] & 0xF0) | (header[6] >> 4);
+    if (mapper != 0 || prg_banks == 0 || prg_banks > 2) {
+        fclose(file);
+        return false;
+    }
+
+    // Skip the 512 byte trainer if there is one
+    if (header[6] & 0x04) {
+        fseek(file, 512, SEEK_CUR);
+    }
+
+    // PRG rom is mapped to 0x8000-0xFFFF, a single 16kb bank is mirrored at 0xC000
+    size_t prg_size = prg_banks * PRG_BANK_SIZE;
+    if (fread(&bus->ram[0x8000], 1, prg_size, file) != prg_size) {
+        fclose(file);
+        return false;
+    }
+    if (prg_banks == 1) {
+        memcpy(&bus->ram[0xC000], &bus->ram[0x8000], PRG_BANK_SIZE);
+    }
+
+    fclose(file);
+    return true;
+}
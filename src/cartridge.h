@@ -0,0 +1,18 @@
+/*
+ * The cartridge holds the program rom of the game.
+ * Roms are stored in the iNES format, a 16 byte header followed by the program (PRG) and character (CHR) rom.
+ *
+ * https://www.nesdev.org/wiki/INES
+ * */
+
+#pragma once
+#ifndef CARTRIDGE_H
+#define CARTRIDGE_H
+
+#include <stdint.h>
+#include "bus.h"
+
+// Load an iNES rom into the bus. Only mapper 0 (NROM) is supported for now
+bool CartridgeLoad(Bus *bus, const char *path);
+
+#endif
@@ -6,6 +6,7 @@
 #include <stdint.h>
 #include "cpu.h"
 #include "bus.h"
+#include "profiler.h"
 
 // Initialize CPU
 void CpuInit(CPU *cpu) {
@@ -17,6 +18,13 @@ void CpuInit(CPU *cpu) {
     cpu->registers.Flag = 0;    // Sets all flag statuses to 0
     cpu->registers.StackPointer = 0x00;
     cpu->registers.ProgramCounter = 0x0000;
+
+    cpu->cycles = 0;
+    cpu->current_opcode = 0x00;
+    cpu->current_address = 0x0000;
+    cpu->mode = None;
+    cpu->page_crossed = false;
+    cpu->unimplemented = 0;
 }
 
 void CpuWrite(CPU *cpu, uint16_t address, uint8_t value) {
@@ -27,304 +35,847 @@ void CpuWrite(CPU *cpu, uint16_t address, uint8_t value) {
 
 uint8_t CpuRead(CPU *cpu, uint16_t address) {
     if (cpu->bus != NULL) {
-        BusRead(cpu->bus, address);
+        return BusRead(cpu->bus, address);
     }
+    return 0x00;
 }
 
 void CpuConnectToBus(CPU *cpu, Bus *bus) {
     cpu->bus = bus;
 }
 
-// TODO: Fix this
-void CpuReset() {
-    CpuRegister.ProgramCounter = 0xFFFC;
-    CpuRegister.ProgramCounter = 0x00FF;
-    CpuRegister.Flag &= ~(1 << ProcessorFlag::Carry);
-    CpuRegister.Flag &= ~(1 << ProcessorFlag::Zero);
-    CpuRegister.Flag &= ~(1 << ProcessorFlag::Interrupt);
-    CpuRegister.Flag &= ~(1 << ProcessorFlag::Decimal);
-    CpuRegister.Flag &= ~(1 << ProcessorFlag::Break);
-    CpuRegister.Flag &= ~(1 << ProcessorFlag::Overflow);
-    CpuRegister.Flag &= ~(1 << ProcessorFlag::Negative);
+// Jump to the address in the reset vector and put the registers in their power up state
+void CpuReset(CPU *cpu) {
+    uint16_t low = CpuRead(cpu, 0xFFFC);
+    uint16_t high = CpuRead(cpu, 0xFFFD);
+    cpu->registers.ProgramCounter = (high << 8) | low;
+    cpu->registers.StackPointer = 0xFD;
+    cpu->registers.Flag &= ~ProcessorFlag::Carry;
+    cpu->registers.Flag &= ~ProcessorFlag::Zero;
+    cpu->registers.Flag &= ~ProcessorFlag::Decimal;
+    cpu->registers.Flag &= ~ProcessorFlag::Break;
+    cpu->registers.Flag &= ~ProcessorFlag::Overflow;
+    cpu->registers.Flag &= ~ProcessorFlag::Negative;
+    // Reset disables interrupts, and the unused bit always reads back as 1
+    cpu->registers.Flag |= ProcessorFlag::Interrupt;
+    cpu->registers.Flag |= ProcessorFlag::Unused;
+    cpu->cycles = 7;    // Reset takes 7 cycles
+}
+
+// Non maskable interrupt, sent by the PPU when vertical blank starts
+void CpuNmi(CPU *cpu) {
+    CpuPush(cpu, cpu->registers.ProgramCounter >> 8);
+    CpuPush(cpu, cpu->registers.ProgramCounter & 0xFF);
+    CpuPush(cpu, (cpu->registers.Flag & ~ProcessorFlag::Break) | ProcessorFlag::Unused);
+    cpu->registers.Flag |= ProcessorFlag::Interrupt;
+
+    uint16_t low = CpuRead(cpu, 0xFFFA);
+    uint16_t high = CpuRead(cpu, 0xFFFB);
+    cpu->registers.ProgramCounter = (high << 8) | low;
+    cpu->cycles += 7;
+}
+
+// Fetch the next opcode and execute it
+void CpuStep(CPU *cpu) {
+    uint64_t start = cpu->cycles;
+    cpu->current_opcode = CpuRead(cpu, cpu->registers.ProgramCounter++);
+    cpu->cycles += InstructionCycles[cpu->current_opcode];
+    cpu->page_crossed = false;
+
+    const Instruction instruction = OpcodeMatrix[cpu->current_opcode];
+
+    switch (instruction.mode) {
+        case None: cpu->mode = None; break;
+        case Implicit: IMP(cpu); break;
+        case Accumulator: ACC(cpu); break;
+        case Immediate: IMM(cpu); break;
+        case ZeroPage: ZPO(cpu); break;
+        case ZeroPageX: ZPX(cpu); break;
+        case ZeroPageY: ZPY(cpu); break;
+        case Relative: REL(cpu); break;
+        case Absolute: ABS(cpu); break;
+        case AbsoluteX: ABX(cpu); break;
+        case AbsoluteY: ABY(cpu); break;
+        case Indirect: IND(cpu); break;
+        case IndirectX: IDX(cpu); break;
+        case IndirectY: IDY(cpu); break;
+    }
+
+    // Every Opcode is listed so the compiler warns (-Wswitch) when one is missing
+    switch (instruction.opcode) {
+        case ADC: OpADC(cpu); break;
+        case AND: OpAND(cpu); break;
+        case ASL: OpASL(cpu); break;
+        case BCC: OpBCC(cpu); break;
+        case BCS: OpBCS(cpu); break;
+        case BEQ: OpBEQ(cpu); break;
+        case BIT: OpBIT(cpu); break;
+        case BMI: OpBMI(cpu); break;
+        case BNE: OpBNE(cpu); break;
+        case BPL: OpBPL(cpu); break;
+        case BRK: OpBRK(cpu); break;
+        case BVC: OpBVC(cpu); break;
+        case BVS: OpBVS(cpu); break;
+        case CLC: OpCLC(cpu); break;
+        case CLD: OpCLD(cpu); break;
+        case CLI: OpCLI(cpu); break;
+        case CLV: OpCLV(cpu); break;
+        case CMP: OpCMP(cpu); break;
+        case CPX: OpCPX(cpu); break;
+        case CPY: OpCPY(cpu); break;
+        case DEC: OpDEC(cpu); break;
+        case DEX: OpDEX(cpu); break;
+        case DEY: OpDEY(cpu); break;
+        case EOR: OpEOR(cpu); break;
+        case INC: OpINC(cpu); break;
+        case INX: OpINX(cpu); break;
+        case INY: OpINY(cpu); break;
+        case JMP: OpJMP(cpu); break;
+        case JSR: OpJSR(cpu); break;
+        case LDA: OpLDA(cpu); break;
+        case LDX: OpLDX(cpu); break;
+        case LDY: OpLDY(cpu); break;
+        case LSR: OpLSR(cpu); break;
+        case NOP: OpNOP(cpu); break;
+        case ORA: OpORA(cpu); break;
+        case PHA: OpPHA(cpu); break;
+        case PHP: OpPHP(cpu); break;
+        case PLA: OpPLA(cpu); break;
+        case PLP: OpPLP(cpu); break;
+        case ROL: OpROL(cpu); break;
+        case ROR: OpROR(cpu); break;
+        case RTI: OpRTI(cpu); break;
+        case RTS: OpRTS(cpu); break;
+        case SBC: OpSBC(cpu); break;
+        case SEC: OpSEC(cpu); break;
+        case SED: OpSED(cpu); break;
+        case SEI: OpSEI(cpu); break;
+        case STA: OpSTA(cpu); break;
+        case STX: OpSTX(cpu); break;
+        case STY: OpSTY(cpu); break;
+        case TAX: OpTAX(cpu); break;
+        case TAY: OpTAY(cpu); break;
+        case TSX: OpTSX(cpu); break;
+        case TXA: OpTXA(cpu); break;
+        case TXS: OpTXS(cpu); break;
+        case TYA: OpTYA(cpu); break;
+
+        // Unofficial opcodes
+        case ALR: OpALR(cpu); break;
+        case ANC: OpANC(cpu); break;
+        case ARR: OpARR(cpu); break;
+        case AXS: OpAXS(cpu); break;
+        case LAX: OpLAX(cpu); break;
+        case LAS: OpLAS(cpu); break;
+        case SAX: OpSAX(cpu); break;
+        case SHY: OpSHY(cpu); break;
+        case SHX: OpSHX(cpu); break;
+        case DCP: OpDCP(cpu); break;
+        case ISC: OpISC(cpu); break;
+        case RLA: OpRLA(cpu); break;
+        case RRA: OpRRA(cpu); break;
+        case SLO: OpSLO(cpu); break;
+        case SRE: OpSRE(cpu); break;
+        case SKB: OpNOP(cpu); break;
+        case IGN: OpNOP(cpu); break;
+
+        // Not emulated, counted so callers can tell their results are not representative
+        case KIL:
+        case AHX:
+        case TAS:
+        case XAA:
+            cpu->unimplemented++;
+            break;
+    }
+
+    PROFILE_OPCODE(cpu->current_opcode, cpu->cycles - start);
+}
+
+// Read the value the current instruction operates on.
+// Addressing modes only resolve the address, so stores and jumps never read their target.
+// Indexed reads that cross a page take one more cycle.
+uint8_t CpuReadOperand(CPU *cpu) {
+    if (cpu->mode == Accumulator) {
+        return cpu->registers.Accumulator;
+    }
+    cpu->cycles += cpu->page_crossed;
+    return CpuRead(cpu, cpu->current_address);
+}
+
+// ---------- Helper Functions ----------
+
+// Read the value of a read-modify-write instruction (no page crossing cycle)
+static uint8_t CpuReadModify(CPU *cpu) {
+    if (cpu->mode == Accumulator) {
+        return cpu->registers.Accumulator;
+    }
+    return CpuRead(cpu, cpu->current_address);
 }
 
-// TODO: Do this
-void CpuStep() {
+// Write back the result of a read-modify-write instruction
+static void CpuWriteModify(CPU *cpu, uint8_t value) {
+    if (cpu->mode == Accumulator) {
+        cpu->registers.Accumulator = value;
+    } else {
+        CpuWrite(cpu, cpu->current_address, value);
+    }
+}
 
+static void CpuSetFlag(CPU *cpu, ProcessorFlag flag, bool set) {
+    if (set) {
+        cpu->registers.Flag |= flag;
+    } else {
+        cpu->registers.Flag &= ~flag;
+    }
+}
+
+// Set the Zero and Negative flags from a result
+static void CpuSetZeroNegative(CPU *cpu, uint8_t value) {
+    CpuSetFlag(cpu, Zero, value == 0x00);
+    CpuSetFlag(cpu, Negative, value & 0x80);
+}
+
+// The stack lives in page 0x0100 and grows down
+void CpuPush(CPU *cpu, uint8_t value) {
+    CpuWrite(cpu, 0x0100 | cpu->registers.StackPointer, value);
+    cpu->registers.StackPointer--;
+}
+
+uint8_t CpuPull(CPU *cpu) {
+    cpu->registers.StackPointer++;
+    return CpuRead(cpu, 0x0100 | cpu->registers.StackPointer);
+}
+
+// Branches take one more cycle when taken and another when they land on a different page
+static void CpuBranch(CPU *cpu, bool condition) {
+    if (condition) {
+        cpu->cycles++;
+        if ((cpu->current_address & 0xFF00) != (cpu->registers.ProgramCounter & 0xFF00)) {
+            cpu->cycles++;
+        }
+        cpu->registers.ProgramCounter = cpu->current_address;
+    }
+}
+
+static void CpuCompare(CPU *cpu, uint8_t reg, uint8_t value) {
+    CpuSetFlag(cpu, Carry, reg >= value);
+    CpuSetZeroNegative(cpu, reg - value);
+}
+
+// A = A + value + Carry, the NES has no decimal mode
+static void CpuAddWithCarry(CPU *cpu, uint8_t value) {
+    uint8_t a = cpu->registers.Accumulator;
+    uint16_t sum = a + value + (cpu->registers.Flag & Carry ? 1 : 0);
+    uint8_t result = (uint8_t)sum;
+
+    CpuSetFlag(cpu, Carry, sum > 0xFF);
+    // Overflow when both inputs have the same sign and the result does not
+    CpuSetFlag(cpu, Overflow, (~(a ^ value) & (a ^ result)) & 0x80);
+    cpu->registers.Accumulator = result;
+    CpuSetZeroNegative(cpu, result);
+}
+
+static uint8_t CpuShiftLeft(CPU *cpu, uint8_t value) {
+    CpuSetFlag(cpu, Carry, value & 0x80);
+    value <<= 1;
+    CpuSetZeroNegative(cpu, value);
+    return value;
+}
+
+static uint8_t CpuShiftRight(CPU *cpu, uint8_t value) {
+    CpuSetFlag(cpu, Carry, value & 0x01);
+    value >>= 1;
+    CpuSetZeroNegative(cpu, value);
+    return value;
+}
+
+static uint8_t CpuRotateLeft(CPU *cpu, uint8_t value) {
+    uint8_t carry = cpu->registers.Flag & Carry ? 0x01 : 0x00;
+    CpuSetFlag(cpu, Carry, value & 0x80);
+    value = (value << 1) | carry;
+    CpuSetZeroNegative(cpu, value);
+    return value;
+}
+
+static uint8_t CpuRotateRight(CPU *cpu, uint8_t value) {
+    uint8_t carry = cpu->registers.Flag & Carry ? 0x80 : 0x00;
+    CpuSetFlag(cpu, Carry, value & 0x01);
+    value = (value >> 1) | carry;
+    CpuSetZeroNegative(cpu, value);
+    return value;
+}
+
+// Index an absolute address and remember whether it crossed a page
+static uint16_t CpuIndex(CPU *cpu, uint16_t base, uint8_t index) {
+    uint16_t address = base + index;
+    cpu->page_crossed = (base & 0xFF00) != (address & 0xFF00);
+    return address;
 }
 
 // ---------- Addressing Modes Functions ----------
 
 // Implicit
 void IMP(CPU *cpu) {
-    CpuAddressingMode = Implicit;
+    cpu->mode = Implicit;
 }
 
 // Accumulator
 void ACC(CPU *cpu) {
-    CurrentValue = CpuRegister.Accumulator;
-    CpuAddressingMode = Accumulator;
+    cpu->mode = Accumulator;
 }
 
 // Immediate
 void IMM(CPU *cpu) {
-    CurrentAddress = CpuRegister.ProgramCounter++;
-    CurrentValue = Read(CurrentAddress);
-    CpuAddressingMode = Immediate;
+    cpu->current_address = cpu->registers.ProgramCounter++;
+    cpu->mode = Immediate;
+}
+
+// Zero Page
+void ZPO(CPU *cpu) {
+    cpu->current_address = CpuRead(cpu, cpu->registers.ProgramCounter++);
+    cpu->mode = ZeroPage;
+}
+
+// Zero Page X
+void ZPX(CPU *cpu) {
+    // Wraps around within the zero page
+    cpu->current_address = (uint8_t)(CpuRead(cpu, cpu->registers.ProgramCounter++) + cpu->registers.XIndex);
+    cpu->mode = ZeroPageX;
+}
+
+// Zero Page Y
+void ZPY(CPU *cpu) {
+    // Wraps around within the zero page
+    cpu->current_address = (uint8_t)(CpuRead(cpu, cpu->registers.ProgramCounter++) + cpu->registers.YIndex);
+    cpu->mode = ZeroPageY;
+}
+
+// Relative
+void REL(CPU *cpu) {
+    // Signed offset from the next instruction, used by branches
+    int8_t offset = (int8_t)CpuRead(cpu, cpu->registers.ProgramCounter++);
+    cpu->current_address = cpu->registers.ProgramCounter + offset;
+    cpu->mode = Relative;
+}
+
+// Absolute
+void ABS(CPU *cpu) {
+    uint16_t low = CpuRead(cpu, cpu->registers.ProgramCounter++);
+    uint16_t high = CpuRead(cpu, cpu->registers.ProgramCounter++);
+    cpu->current_address = (high << 8) | low;
+    cpu->mode = Absolute;
+}
+
+// Absolute X
+void ABX(CPU *cpu) {
+    uint16_t low = CpuRead(cpu, cpu->registers.ProgramCounter++);
+    uint16_t high = CpuRead(cpu, cpu->registers.ProgramCounter++);
+    cpu->current_address = CpuIndex(cpu, (high << 8) | low, cpu->registers.XIndex);
+    cpu->mode = AbsoluteX;
+}
+
+// Absolute Y
+void ABY(CPU *cpu) {
+    uint16_t low = CpuRead(cpu, cpu->registers.ProgramCounter++);
+    uint16_t high = CpuRead(cpu, cpu->registers.ProgramCounter++);
+    cpu->current_address = CpuIndex(cpu, (high << 8) | low, cpu->registers.YIndex);
+    cpu->mode = AbsoluteY;
+}
+
+// Indirect
+void IND(CPU *cpu) {
+    uint16_t low = CpuRead(cpu, cpu->registers.ProgramCounter++);
+    uint16_t high = CpuRead(cpu, cpu->registers.ProgramCounter++);
+    uint16_t pointer = (high << 8) | low;
+    // The 6502 does not carry into the high byte when the pointer is at the end of a page
+    uint16_t pointer_high = (pointer & 0xFF00) | ((pointer + 1) & 0x00FF);
+    cpu->current_address = (CpuRead(cpu, pointer_high) << 8) | CpuRead(cpu, pointer);
+    cpu->mode = Indirect;
+}
+
+// Indirect X
+void IDX(CPU *cpu) {
+    uint8_t pointer = CpuRead(cpu, cpu->registers.ProgramCounter++) + cpu->registers.XIndex;
+    uint16_t low = CpuRead(cpu, pointer);
+    uint16_t high = CpuRead(cpu, (uint8_t)(pointer + 1));
+    cpu->current_address = (high << 8) | low;
+    cpu->mode = IndirectX;
+}
+
+// Indirect Y
+void IDY(CPU *cpu) {
+    uint8_t pointer = CpuRead(cpu, cpu->registers.ProgramCounter++);
+    uint16_t low = CpuRead(cpu, pointer);
+    uint16_t high = CpuRead(cpu, (uint8_t)(pointer + 1));
+    cpu->current_address = CpuIndex(cpu, (high << 8) | low, cpu->registers.YIndex);
+    cpu->mode = IndirectY;
 }
 
 // ---------- Opcode Functions ----------
 
+// Add with Carry
+void OpADC(CPU *cpu) {
+    CpuAddWithCarry(cpu, CpuReadOperand(cpu));
+}
+
+// Logical And
+void OpAND(CPU *cpu) {
+    cpu->registers.Accumulator &= CpuReadOperand(cpu);
+    CpuSetZeroNegative(cpu, cpu->registers.Accumulator);
+}
+
+// Arithmetic Shift Left
+void OpASL(CPU *cpu) {
+    CpuWriteModify(cpu, CpuShiftLeft(cpu, CpuReadModify(cpu)));
+}
+
 // Branch if Carry Clear
-void BCC() {
+void OpBCC(CPU *cpu) {
+    CpuBranch(cpu, !(cpu->registers.Flag & Carry));
+}
+
+// Branch if Carry Set
+void OpBCS(CPU *cpu) {
+    CpuBranch(cpu, cpu->registers.Flag & Carry);
+}
+
+// Branch if Equal
+void OpBEQ(CPU *cpu) {
+    CpuBranch(cpu, cpu->registers.Flag & Zero);
+}
+
+// Bit Test
+// Zero is set from A AND value, Overflow and Negative are copied from bits 6 and 7 of the value
+void OpBIT(CPU *cpu) {
+    uint8_t value = CpuReadOperand(cpu);
+    CpuSetFlag(cpu, Zero, (cpu->registers.Accumulator & value) == 0x00);
+    CpuSetFlag(cpu, Overflow, value & 0x40);
+    CpuSetFlag(cpu, Negative, value & 0x80);
+}
 
+// Branch if Minus
+void OpBMI(CPU *cpu) {
+    CpuBranch(cpu, cpu->registers.Flag & Negative);
+}
+
+// Branch if Not Equal
+void OpBNE(CPU *cpu) {
+    CpuBranch(cpu, !(cpu->registers.Flag & Zero));
+}
+
+// Branch if Positive
+void OpBPL(CPU *cpu) {
+    CpuBranch(cpu, !(cpu->registers.Flag & Negative));
 }
 
 // Force Interrupt
 // Forces the generation of an interrupt request
-void BRK() {
-    // Set the Break Flag to 1
-    CpuRegister.Flag |= (1 << ProcessorFlag::Break);
-    cycles += 7;
+void OpBRK(CPU *cpu) {
+    // The byte after BRK is skipped, so the return address is BRK + 2
+    uint16_t address = cpu->registers.ProgramCounter + 1;
+    CpuPush(cpu, address >> 8);
+    CpuPush(cpu, address & 0xFF);
+    // The pushed status has the Break Flag set to 1
+    CpuPush(cpu, cpu->registers.Flag | ProcessorFlag::Break | ProcessorFlag::Unused);
+    cpu->registers.Flag |= ProcessorFlag::Interrupt;
+
+    uint16_t low = CpuRead(cpu, 0xFFFE);
+    uint16_t high = CpuRead(cpu, 0xFFFF);
+    cpu->registers.ProgramCounter = (high << 8) | low;
+}
+
+// Branch if Overflow Clear
+void OpBVC(CPU *cpu) {
+    CpuBranch(cpu, !(cpu->registers.Flag & Overflow));
+}
+
+// Branch if Overflow Set
+void OpBVS(CPU *cpu) {
+    CpuBranch(cpu, cpu->registers.Flag & Overflow);
 }
 
 // Clear Carry Flag
-void CLC() {
+void OpCLC(CPU *cpu) {
     // Set Carry Flag to 0
-    CpuRegister.Flag &= ~(1 << ProcessorFlag::Carry);
-    cycles += 2;
+    cpu->registers.Flag &= ~ProcessorFlag::Carry;
 }
 
 // Clear Decimal Mode
-void CLD() {
+void OpCLD(CPU *cpu) {
     // Set Decimal Mode Flag to 0
-    CpuRegister.Flag &= ~(1 << ProcessorFlag::Decimal);
-    cycles += 2;
+    cpu->registers.Flag &= ~ProcessorFlag::Decimal;
 }
 
 // Clear Interrupt Disable
-void CLI() {
+void OpCLI(CPU *cpu) {
     // Set Interrupt Disable Flag to 0
-    CpuRegister.Flag &= ~(1 << ProcessorFlag::Interrupt);
-    cycles += 2;
+    cpu->registers.Flag &= ~ProcessorFlag::Interrupt;
 }
 
 // Clear Overflow Flag
-void CLV() {
+void OpCLV(CPU *cpu) {
     // Set Overflow Flag to 0
-    CpuRegister.Flag &= ~(1 << ProcessorFlag::Overflow);
-    cycles += 2;
+    cpu->registers.Flag &= ~ProcessorFlag::Overflow;
 }
 
-// Decrement X Register
-void DEX() {
-    // Decrement X register
-    CpuRegister.XIndex--;
-    cycles += 2;
+// Compare
+void OpCMP(CPU *cpu) {
+    CpuCompare(cpu, cpu->registers.Accumulator, CpuReadOperand(cpu));
+}
 
-    if (CpuRegister.XIndex == 0x00) {
-        CpuRegister.Flag |= (1 << ProcessorFlag::Zero);
-    } else {
-        CpuRegister.Flag &= ~(1 << ProcessorFlag::Zero);
-    }
+// Compare X Register
+void OpCPX(CPU *cpu) {
+    CpuCompare(cpu, cpu->registers.XIndex, CpuReadOperand(cpu));
+}
 
-    if ((CpuRegister.XIndex & 0x80) >> 7) {
-        CpuRegister.Flag |= (1 << ProcessorFlag::Negative);
-    } else {
-        CpuRegister.Flag &= ~(1 << ProcessorFlag::Negative);
-    }
+// Compare Y Register
+void OpCPY(CPU *cpu) {
+    CpuCompare(cpu, cpu->registers.YIndex, CpuReadOperand(cpu));
 }
 
-// Decrement Y Register
-void DEY() {
-    // Decrement X register
-    CpuRegister.YIndex--;
-    cycles += 2;
+// Decrement Memory
+void OpDEC(CPU *cpu) {
+    uint8_t value = CpuReadModify(cpu) - 1;
+    CpuWriteModify(cpu, value);
+    CpuSetZeroNegative(cpu, value);
+}
 
-    if (CpuRegister.YIndex == 0x00) {
-        CpuRegister.Flag |= (1 << ProcessorFlag::Zero);
-    } else {
-        CpuRegister.Flag &= ~(1 << ProcessorFlag::Zero);
-    }
+// Decrement X Register
+void OpDEX(CPU *cpu) {
+    cpu->registers.XIndex--;
+    CpuSetZeroNegative(cpu, cpu->registers.XIndex);
+}
 
-    if ((CpuRegister.YIndex & 0x80) >> 7) {
-        CpuRegister.Flag |= (1 << ProcessorFlag::Negative);
-    } else {
-        CpuRegister.Flag &= ~(1 << ProcessorFlag::Negative);
-    }
+// Decrement Y Register
+void OpDEY(CPU *cpu) {
+    cpu->registers.YIndex--;
+    CpuSetZeroNegative(cpu, cpu->registers.YIndex);
 }
 
-// Increment X Register
-void INX() {
-    // Increment X register
-    CpuRegister.XIndex++;
-    cycles += 2;
+// Exclusive OR
+void OpEOR(CPU *cpu) {
+    cpu->registers.Accumulator ^= CpuReadOperand(cpu);
+    CpuSetZeroNegative(cpu, cpu->registers.Accumulator);
+}
 
-    if (CpuRegister.XIndex == 0x00) {
-        CpuRegister.Flag |= (1 << ProcessorFlag::Zero);
-    } else {
-        CpuRegister.Flag &= ~(1 << ProcessorFlag::Zero);
-    }
+// Increment Memory
+void OpINC(CPU *cpu) {
+    uint8_t value = CpuReadModify(cpu) + 1;
+    CpuWriteModify(cpu, value);
+    CpuSetZeroNegative(cpu, value);
+}
 
-    if ((CpuRegister.XIndex & 0x80) >> 7) {
-        CpuRegister.Flag |= (1 << ProcessorFlag::Negative);
-    } else {
-        CpuRegister.Flag &= ~(1 << ProcessorFlag::Negative);
-    }
+// Increment X Register
+void OpINX(CPU *cpu) {
+    cpu->registers.XIndex++;
+    CpuSetZeroNegative(cpu, cpu->registers.XIndex);
 }
 
 // Increment Y Register
-void INY() {
-    // Increment X register
-    CpuRegister.YIndex++;
-    cycles += 2;
-
-    if (CpuRegister.YIndex == 0x00) {
-        CpuRegister.Flag |= (1 << ProcessorFlag::Zero);
-    } else {
-        CpuRegister.Flag &= ~(1 << ProcessorFlag::Zero);
-    }
-
-    if ((CpuRegister.YIndex & 0x80) >> 7) {
-        CpuRegister.Flag |= (1 << ProcessorFlag::Negative);
-    } else {
-        CpuRegister.Flag &= ~(1 << ProcessorFlag::Negative);
-    }
+void OpINY(CPU *cpu) {
+    cpu->registers.YIndex++;
+    CpuSetZeroNegative(cpu, cpu->registers.YIndex);
 }
 
 // Jump
-void JMP() {
+void OpJMP(CPU *cpu) {
     // Set program counter to the address specified
-    CpuRegister.ProgramCounter = CurrentAddress;
-    if (CpuAddressingMode == Absolute) {
-        cycles += 3;
-    } else if (CpuAddressingMode == Indirect) {
-        cycles += 5;
-    }
+    cpu->registers.ProgramCounter = cpu->current_address;
 }
 
 // Jump to Subroutine
-void JSR() {
-
+void OpJSR(CPU *cpu) {
+    // Push the address of the last byte of JSR, RTS adds 1 back
+    uint16_t address = cpu->registers.ProgramCounter - 1;
+    CpuPush(cpu, address >> 8);
+    CpuPush(cpu, address & 0xFF);
+    cpu->registers.ProgramCounter = cpu->current_address;
 }
 
-// TODO: Finish LDA with Addressing Modes
 // Load Accumulator
-void LDA() {
+void OpLDA(CPU *cpu) {
     // Loads a byte of memory into the accumulator
-    CpuRegister.Accumulator = CurrentValue;
-    if (CpuRegister.Accumulator == 0) {
-        // Set Zero Flag to 1 if Accumulator == 0
-        CpuRegister.Flag |= (1 << ProcessorFlag::Zero);
-    } else if ((CpuRegister.Accumulator & 0b10000000) > 0) {
-        // Set Negative Flag to 1 if the bit 7 of Accumulator is set
-        CpuRegister.Flag |= (1 << ProcessorFlag::Negative);
+    cpu->registers.Accumulator = CpuReadOperand(cpu);
+    CpuSetZeroNegative(cpu, cpu->registers.Accumulator);
+}
+
+// Load X Register
+void OpLDX(CPU *cpu) {
+    cpu->registers.XIndex = CpuReadOperand(cpu);
+    CpuSetZeroNegative(cpu, cpu->registers.XIndex);
+}
+
+// Load Y Register
+void OpLDY(CPU *cpu) {
+    cpu->registers.YIndex = CpuReadOperand(cpu);
+    CpuSetZeroNegative(cpu, cpu->registers.YIndex);
+}
+
+// Logical Shift Right
+void OpLSR(CPU *cpu) {
+    CpuWriteModify(cpu, CpuShiftRight(cpu, CpuReadModify(cpu)));
+}
+
+// No Operation
+void OpNOP(CPU *cpu) {
+    // Unofficial NOPs with an operand still read it
+    if (cpu->mode != None && cpu->mode != Implicit && cpu->mode != Immediate) {
+        CpuReadOperand(cpu);
     }
 }
 
+// Logical Inclusive Or
+void OpORA(CPU *cpu) {
+    cpu->registers.Accumulator |= CpuReadOperand(cpu);
+    CpuSetZeroNegative(cpu, cpu->registers.Accumulator);
+}
+
+// Push Accumulator
+void OpPHA(CPU *cpu) {
+    CpuPush(cpu, cpu->registers.Accumulator);
+}
+
+// Push Processor Status
+void OpPHP(CPU *cpu) {
+    // The pushed status always has the Break and Unused Flags set to 1
+    CpuPush(cpu, cpu->registers.Flag | ProcessorFlag::Break | ProcessorFlag::Unused);
+}
+
+// Pull Accumulator
+void OpPLA(CPU *cpu) {
+    cpu->registers.Accumulator = CpuPull(cpu);
+    CpuSetZeroNegative(cpu, cpu->registers.Accumulator);
+}
+
+// Pull Processor Status
+void OpPLP(CPU *cpu) {
+    // Break only exists on the stack, Unused always reads back as 1
+    cpu->registers.Flag = (CpuPull(cpu) & ~ProcessorFlag::Break) | ProcessorFlag::Unused;
+}
+
+// Rotate Left
+void OpROL(CPU *cpu) {
+    CpuWriteModify(cpu, CpuRotateLeft(cpu, CpuReadModify(cpu)));
+}
+
+// Rotate Right
+void OpROR(CPU *cpu) {
+    CpuWriteModify(cpu, CpuRotateRight(cpu, CpuReadModify(cpu)));
+}
+
+// Return from Interrupt
+void OpRTI(CPU *cpu) {
+    cpu->registers.Flag = (CpuPull(cpu) & ~ProcessorFlag::Break) | ProcessorFlag::Unused;
+    uint16_t low = CpuPull(cpu);
+    uint16_t high = CpuPull(cpu);
+    cpu->registers.ProgramCounter = (high << 8) | low;
+}
+
+// Return from Subroutine
+void OpRTS(CPU *cpu) {
+    uint16_t low = CpuPull(cpu);
+    uint16_t high = CpuPull(cpu);
+    cpu->registers.ProgramCounter = ((high << 8) | low) + 1;
+}
+
+// Subtract with Carry
+void OpSBC(CPU *cpu) {
+    // A - value - (1 - Carry) is the same as A + ~value + Carry
+    CpuAddWithCarry(cpu, ~CpuReadOperand(cpu));
+}
 
 // Set Carry Flag
-void SEC() {
+void OpSEC(CPU *cpu) {
     // Set the Carry Flag to 1
-    CpuRegister.Flag |= (1 << ProcessorFlag::Carry);
-    cycles += 2;
+    cpu->registers.Flag |= ProcessorFlag::Carry;
 }
 
 // Set Decimal Flag
-void SED() {
+void OpSED(CPU *cpu) {
     // Set the Decimal Mode Flag to 1
-    CpuRegister.Flag |= (1 << ProcessorFlag::Decimal);
-    cycles += 2;
+    cpu->registers.Flag |= ProcessorFlag::Decimal;
 }
 
 // Set Interrupt Disable
-void SEI() {
+void OpSEI(CPU *cpu) {
     // Set the Interrupt Disable Flag to 1
-    CpuRegister.Flag |= (1 << ProcessorFlag::Interrupt);
-    cycles += 2;
+    cpu->registers.Flag |= ProcessorFlag::Interrupt;
 }
 
-// Transfer Accumulator to Y
-void TAY() {
-    // Y = A
-    CpuRegister.YIndex = CpuRegister.Accumulator;
+// Store Accumulator
+void OpSTA(CPU *cpu) {
+    CpuWrite(cpu, cpu->current_address, cpu->registers.Accumulator);
+}
 
-    if ((CpuRegister.YIndex & 0x80) >> 7) {
-        CpuRegister.Flag |= (1 << ProcessorFlag::Negative);
-    } else {
-        CpuRegister.Flag &= ~(1 << ProcessorFlag::Negative);
-    }
+// Store X Register
+void OpSTX(CPU *cpu) {
+    CpuWrite(cpu, cpu->current_address, cpu->registers.XIndex);
+}
 
-    if (CpuRegister.YIndex == 0) {
-        CpuRegister.Flag |= (1 << ProcessorFlag::Zero);
-    } else {
-        CpuRegister.Flag &= ~(1 << ProcessorFlag::Zero);
-    }
-    cycles += 2;
+// Store Y Register
+void OpSTY(CPU *cpu) {
+    CpuWrite(cpu, cpu->current_address, cpu->registers.YIndex);
 }
 
-// Transfer Stack Pointer to X
-void TSX() {
-    // X = SP
-    CpuRegister.XIndex = CpuRegister.StackPointer;
+// Transfer Accumulator to X
+void OpTAX(CPU *cpu) {
+    // X = A
+    cpu->registers.XIndex = cpu->registers.Accumulator;
+    CpuSetZeroNegative(cpu, cpu->registers.XIndex);
+}
 
-    if ((CpuRegister.XIndex & 0x80) >> 7) {
-        CpuRegister.Flag |= (1 << ProcessorFlag::Negative);
-    } else {
-        CpuRegister.Flag &= ~(1 << ProcessorFlag::Negative);
-    }
+// Transfer Accumulator to Y
+void OpTAY(CPU *cpu) {
+    // Y = A
+    cpu->registers.YIndex = cpu->registers.Accumulator;
+    CpuSetZeroNegative(cpu, cpu->registers.YIndex);
+}
 
-    if (CpuRegister.XIndex == 0) {
-        CpuRegister.Flag |= (1 << ProcessorFlag::Zero);
-    } else {
-        CpuRegister.Flag &= ~(1 << ProcessorFlag::Zero);
-    }
-    cycles += 2;
+// Transfer Stack Pointer to X
+void OpTSX(CPU *cpu) {
+    // X = SP
+    cpu->registers.XIndex = cpu->registers.StackPointer;
+    CpuSetZeroNegative(cpu, cpu->registers.XIndex);
 }
 
 // Transfer X to Accumulator
-void TXA() {
+void OpTXA(CPU *cpu) {
     // A = X
-    CpuRegister.Accumulator = CpuRegister.XIndex;
-
-    if ((CpuRegister.Accumulator & 0x80) >> 7) {
-        CpuRegister.Flag |= (1 << ProcessorFlag::Negative);
-    } else {
-        CpuRegister.Flag &= ~(1 << ProcessorFlag::Negative);
-    }
-
-    if (CpuRegister.Accumulator == 0) {
-        CpuRegister.Flag |= (1 << ProcessorFlag::Zero);
-    } else {
-        CpuRegister.Flag &= ~(1 << ProcessorFlag::Zero);
-    }
-    cycles += 2;
+    cpu->registers.Accumulator = cpu->registers.XIndex;
+    CpuSetZeroNegative(cpu, cpu->registers.Accumulator);
 }
 
 // Transfer X to Stack Pointer
-void TXS() {
+void OpTXS(CPU *cpu) {
     // SP = X
-    CpuRegister.StackPointer = CpuRegister.XIndex;
-    cycles += 2;
+    cpu->registers.StackPointer = cpu->registers.XIndex;
 }
 
 // Transfer Y to Accumulator
-void TYA() {
+void OpTYA(CPU *cpu) {
     // A = Y
-    CpuRegister.Accumulator = CpuRegister.YIndex;
+    cpu->registers.Accumulator = cpu->registers.YIndex;
+    CpuSetZeroNegative(cpu, cpu->registers.Accumulator);
+}
 
-    if ((CpuRegister.Accumulator & 0x80) >> 7) {
-        CpuRegister.Flag |= (1 << ProcessorFlag::Negative);
-    } else {
-        CpuRegister.Flag &= ~(1 << ProcessorFlag::Negative);
-    }
+// ---------- Unofficial Opcode Functions ----------
+// https://www.nesdev.org/wiki/Programming_with_unofficial_opcodes
 
-    if (CpuRegister.Accumulator == 0) {
-        CpuRegister.Flag |= (1 << ProcessorFlag::Zero);
-    } else {
-        CpuRegister.Flag &= ~(1 << ProcessorFlag::Zero);
+// AND then Logical Shift Right
+void OpALR(CPU *cpu) {
+    cpu->registers.Accumulator = CpuShiftRight(cpu, cpu->registers.Accumulator & CpuReadOperand(cpu));
+}
+
+// AND then copy Negative to Carry
+void OpANC(CPU *cpu) {
+    cpu->registers.Accumulator &= CpuReadOperand(cpu);
+    CpuSetZeroNegative(cpu, cpu->registers.Accumulator);
+    CpuSetFlag(cpu, Carry, cpu->registers.Accumulator & 0x80);
+}
+
+// AND then Rotate Right, Carry is bit 6 and Overflow is bit 6 XOR bit 5 of the result
+void OpARR(CPU *cpu) {
+    uint8_t value = CpuRotateRight(cpu, cpu->registers.Accumulator & CpuReadOperand(cpu));
+    cpu->registers.Accumulator = value;
+    CpuSetFlag(cpu, Carry, value & 0x40);
+    CpuSetFlag(cpu, Overflow, ((value >> 6) ^ (value >> 5)) & 0x01);
+}
+
+// X = (A AND X) - value, without borrow
+void OpAXS(CPU *cpu) {
+    uint8_t value = CpuReadOperand(cpu);
+    uint8_t masked = cpu->registers.Accumulator & cpu->registers.XIndex;
+    CpuSetFlag(cpu, Carry, masked >= value);
+    cpu->registers.XIndex = masked - value;
+    CpuSetZeroNegative(cpu, cpu->registers.XIndex);
+}
+
+// Load Accumulator and X Register
+void OpLAX(CPU *cpu) {
+    cpu->registers.Accumulator = CpuReadOperand(cpu);
+    cpu->registers.XIndex = cpu->registers.Accumulator;
+    CpuSetZeroNegative(cpu, cpu->registers.Accumulator);
+}
+
+// A, X and Stack Pointer = value AND Stack Pointer
+void OpLAS(CPU *cpu) {
+    uint8_t value = CpuReadOperand(cpu) & cpu->registers.StackPointer;
+    cpu->registers.Accumulator = value;
+    cpu->registers.XIndex = value;
+    cpu->registers.StackPointer = value;
+    CpuSetZeroNegative(cpu, value);
+}
+
+// Store A AND X
+void OpSAX(CPU *cpu) {
+    CpuWrite(cpu, cpu->current_address, cpu->registers.Accumulator & cpu->registers.XIndex);
+}
+
+// Store reg AND (high byte of the unindexed address + 1).
+// When indexing crosses a page the stored value also replaces the high byte of the address.
+static void CpuStoreHigh(CPU *cpu, uint8_t reg, uint8_t index) {
+    uint16_t base = cpu->current_address - index;
+    uint8_t value = reg & ((base >> 8) + 1);
+    uint16_t address = cpu->current_address;
+    if (cpu->page_crossed) {
+        address = (value << 8) | (address & 0x00FF);
     }
-    cycles += 2;
+    CpuWrite(cpu, address, value);
+}
+
+// Store Y AND (high byte of address + 1)
+void OpSHY(CPU *cpu) {
+    CpuStoreHigh(cpu, cpu->registers.YIndex, cpu->registers.XIndex);
+}
+
+// Store X AND (high byte of address + 1)
+void OpSHX(CPU *cpu) {
+    CpuStoreHigh(cpu, cpu->registers.XIndex, cpu->registers.YIndex);
+}
+
+// Decrement Memory then Compare
+void OpDCP(CPU *cpu) {
+    uint8_t value = CpuReadModify(cpu) - 1;
+    CpuWriteModify(cpu, value);
+    CpuCompare(cpu, cpu->registers.Accumulator, value);
+}
+
+// Increment Memory then Subtract with Carry
+void OpISC(CPU *cpu) {
+    uint8_t value = CpuReadModify(cpu) + 1;
+    CpuWriteModify(cpu, value);
+    CpuAddWithCarry(cpu, ~value);
+}
+
+// Rotate Left then AND
+void OpRLA(CPU *cpu) {
+    uint8_t value = CpuRotateLeft(cpu, CpuReadModify(cpu));
+    CpuWriteModify(cpu, value);
+    cpu->registers.Accumulator &= value;
+    CpuSetZeroNegative(cpu, cpu->registers.Accumulator);
+}
+
+// Rotate Right then Add with Carry
+void OpRRA(CPU *cpu) {
+    uint8_t value = CpuRotateRight(cpu, CpuReadModify(cpu));
+    CpuWriteModify(cpu, value);
+    CpuAddWithCarry(cpu, value);
+}
+
+// Arithmetic Shift Left then OR
+void OpSLO(CPU *cpu) {
+    uint8_t value = CpuShiftLeft(cpu, CpuReadModify(cpu));
+    CpuWriteModify(cpu, value);
+    cpu->registers.Accumulator |= value;
+    CpuSetZeroNegative(cpu, cpu->registers.Accumulator);
+}
+
+// Logical Shift Right then Exclusive OR
+void OpSRE(CPU *cpu) {
+    uint8_t value = CpuShiftRight(cpu, CpuReadModify(cpu));
+    CpuWriteModify(cpu, value);
+    cpu->registers.Accumulator ^= value;
+    CpuSetZeroNegative(cpu, cpu->registers.Accumulator);
 }
 
 // ---------- Opcode Functions End ----------
@@ -91,6 +91,12 @@ typedef enum {
 
     SKB,
     IGN,
+
+    // Unstable or halting opcodes that are not emulated
+    KIL,
+    AHX,
+    TAS,
+    XAA,
 } Opcode;
 
 
@@ -126,23 +132,23 @@ typedef struct {
 // https://www.nesdev.org/wiki/CPU_unofficial_opcodes
 // https://www.oxyron.de/html/opcodes02.html
 const Instruction OpcodeMatrix[256] = {
-    {BRK, Implicit}, {ORA, IndirectX}, {NOP, None}, {SLO, IndirectX}, {NOP, ZeroPage}, {ORA, ZeroPage}, {ASL, ZeroPage}, {SLO, ZeroPage}, {PHP, Implicit}, {ORA, Immediate}, {ASL, Implicit}, {ANC, Immediate}, {NOP, Absolute}, {ORA, Absolute}, {ASL, Absolute}, {SLO, Absolute},
-    {BPL, Relative}, {ORA, IndirectY}, {NOP, None}, {SLO, IndirectY}, {NOP, ZeroPageX}, {ORA, ZeroPageX}, {ASL, ZeroPageX}, {SLO, ZeroPageX}, {CLC, Implicit}, {ORA, AbsoluteY}, {NOP, Implicit}, {SLO, AbsoluteY}, {NOP, AbsoluteX}, {ORA, AbsoluteX}, {ASL, AbsoluteX}, {SLO, AbsoluteX},
-    {JSR, Absolute}, {AND, IndirectX}, {NOP, None}, {RLA, IndirectX}, {BIT, ZeroPage}, {AND, ZeroPage}, {ROL, ZeroPage}, {RLA, ZeroPage}, {PLP, Immediate}, {AND, Immediate}, {ROL, Implicit}, {ANC, Immediate}, {BIT, Absolute}, {AND, Absolute}, {ROL, Absolute}, {RLA, Absolute},
-    {BMI, Relative}, {AND, IndirectY}, {NOP, None}, {RLA, IndirectY}, {NOP, ZeroPageX}, {AND, ZeroPageX}, {ROL, ZeroPageX}, {RLA, ZeroPageX}, {SEC, Implicit}, {AND, AbsoluteY}, {NOP, Immediate}, {RLA, AbsoluteY}, {NOP, AbsoluteX}, {AND, AbsoluteX}, {ROL, AbsoluteX}, {RLA, AbsoluteX},
-    {RTI, Implicit}, {EOR, IndirectX}, {NOP, None}, {SRE, IndirectX}, {NOP, ZeroPage}, {EOR, ZeroPage}, {LSR, ZeroPage}, {SRE, ZeroPage}, {PHA, Implicit}, {EOR, Immediate}, {LSR, Implicit}, {ALR, Immediate}, {JMP, Absolute}, {EOR, Absolute}, {LSR, Absolute}, {SRE, Absolute},
-    {BVC, Relative}, {EOR, IndirectY}, {NOP, None}, {SRE, IndirectY}, {NOP, ZeroPageX}, {EOR, ZeroPageX}, {LSR, ZeroPageX}, {SRE, ZeroPageX}, {CLI, Implicit}, {EOR, AbsoluteY}, {NOP, Implicit}, {SRE, AbsoluteY}, {NOP, AbsoluteX}, {EOR, AbsoluteX}, {LSR, AbsoluteX}, {SRE, AbsoluteX},
-    {RTS, Implicit}, {ADC, IndirectX}, {NOP, None}, {RRA, IndirectX}, {NOP, ZeroPage}, {ADC, ZeroPage}, {ROR, ZeroPage}, {RRA, ZeroPage}, {PLA, Implicit}, {ADC, Immediate}, {ROR, Immediate}, {ARR, Immediate}, {JMP, Indirect}, {ADC, Absolute}, {ROR, Absolute}, {RRA, Absolute},
-    {BVS, Relative}, {ADC, IndirectY}, {NOP, None}, {RRA, IndirectY}, {NOP, ZeroPageX}, {ADC, ZeroPageX}, {ROR, ZeroPageX}, {RRA, ZeroPageX}, {SEI, Implicit}, {ADC, AbsoluteY}, {NOP, Implicit}, {RRA, AbsoluteY}, {NOP, AbsoluteX}, {ADC, AbsoluteX}, {ROR, AbsoluteX}, {RRA, AbsoluteX},
-    {NOP, Immediate}, {STA, IndirectX}, {NOP, Immediate}, {SAX, IndirectX}, {STY, ZeroPage}, {STA, ZeroPage}, {STX, ZeroPage}, {SAX, ZeroPage}, {DEY, Implicit}, {NOP, Immediate}, {TXA, Immediate}, {NOP, Implicit}, {STY, Absolute}, {STA, Absolute}, {STX, Absolute}, {SAX, Absolute},
-    {BCC, Relative}, {STA, IndirectY}, {NOP, None}, {NOP, IndirectY}, {STY, ZeroPageX}, {STA, ZeroPageX}, {STX, ZeroPageY}, {SAX, ZeroPageY}, {TYA, Implicit}, {STA, AbsoluteY}, {TXS, Implicit}, {NOP, AbsoluteY}, {NOP, AbsoluteX}, {STA, AbsoluteX}, {NOP, AbsoluteY}, {NOP, AbsoluteY},
+    {BRK, Implicit}, {ORA, IndirectX}, {KIL, None}, {SLO, IndirectX}, {NOP, ZeroPage}, {ORA, ZeroPage}, {ASL, ZeroPage}, {SLO, ZeroPage}, {PHP, Implicit}, {ORA, Immediate}, {ASL, Accumulator}, {ANC, Immediate}, {NOP, Absolute}, {ORA, Absolute}, {ASL, Absolute}, {SLO, Absolute},
+    {BPL, Relative}, {ORA, IndirectY}, {KIL, None}, {SLO, IndirectY}, {NOP, ZeroPageX}, {ORA, ZeroPageX}, {ASL, ZeroPageX}, {SLO, ZeroPageX}, {CLC, Implicit}, {ORA, AbsoluteY}, {NOP, Implicit}, {SLO, AbsoluteY}, {NOP, AbsoluteX}, {ORA, AbsoluteX}, {ASL, AbsoluteX}, {SLO, AbsoluteX},
+    {JSR, Absolute}, {AND, IndirectX}, {KIL, None}, {RLA, IndirectX}, {BIT, ZeroPage}, {AND, ZeroPage}, {ROL, ZeroPage}, {RLA, ZeroPage}, {PLP, Implicit}, {AND, Immediate}, {ROL, Accumulator}, {ANC, Immediate}, {BIT, Absolute}, {AND, Absolute}, {ROL, Absolute}, {RLA, Absolute},
+    {BMI, Relative}, {AND, IndirectY}, {KIL, None}, {RLA, IndirectY}, {NOP, ZeroPageX}, {AND, ZeroPageX}, {ROL, ZeroPageX}, {RLA, ZeroPageX}, {SEC, Implicit}, {AND, AbsoluteY}, {NOP, Implicit}, {RLA, AbsoluteY}, {NOP, AbsoluteX}, {AND, AbsoluteX}, {ROL, AbsoluteX}, {RLA, AbsoluteX},
+    {RTI, Implicit}, {EOR, IndirectX}, {KIL, None}, {SRE, IndirectX}, {NOP, ZeroPage}, {EOR, ZeroPage}, {LSR, ZeroPage}, {SRE, ZeroPage}, {PHA, Implicit}, {EOR, Immediate}, {LSR, Accumulator}, {ALR, Immediate}, {JMP, Absolute}, {EOR, Absolute}, {LSR, Absolute}, {SRE, Absolute},
+    {BVC, Relative}, {EOR, IndirectY}, {KIL, None}, {SRE, IndirectY}, {NOP, ZeroPageX}, {EOR, ZeroPageX}, {LSR, ZeroPageX}, {SRE, ZeroPageX}, {CLI, Implicit}, {EOR, AbsoluteY}, {NOP, Implicit}, {SRE, AbsoluteY}, {NOP, AbsoluteX}, {EOR, AbsoluteX}, {LSR, AbsoluteX}, {SRE, AbsoluteX},
+    {RTS, Implicit}, {ADC, IndirectX}, {KIL, None}, {RRA, IndirectX}, {NOP, ZeroPage}, {ADC, ZeroPage}, {ROR, ZeroPage}, {RRA, ZeroPage}, {PLA, Implicit}, {ADC, Immediate}, {ROR, Accumulator}, {ARR, Immediate}, {JMP, Indirect}, {ADC, Absolute}, {ROR, Absolute}, {RRA, Absolute},
+    {BVS, Relative}, {ADC, IndirectY}, {KIL, None}, {RRA, IndirectY}, {NOP, ZeroPageX}, {ADC, ZeroPageX}, {ROR, ZeroPageX}, {RRA, ZeroPageX}, {SEI, Implicit}, {ADC, AbsoluteY}, {NOP, Implicit}, {RRA, AbsoluteY}, {NOP, AbsoluteX}, {ADC, AbsoluteX}, {ROR, AbsoluteX}, {RRA, AbsoluteX},
+    {NOP, Immediate}, {STA, IndirectX}, {NOP, Immediate}, {SAX, IndirectX}, {STY, ZeroPage}, {STA, ZeroPage}, {STX, ZeroPage}, {SAX, ZeroPage}, {DEY, Implicit}, {NOP, Immediate}, {TXA, Implicit}, {XAA, Immediate}, {STY, Absolute}, {STA, Absolute}, {STX, Absolute}, {SAX, Absolute},
+    {BCC, Relative}, {STA, IndirectY}, {KIL, None}, {AHX, IndirectY}, {STY, ZeroPageX}, {STA, ZeroPageX}, {STX, ZeroPageY}, {SAX, ZeroPageY}, {TYA, Implicit}, {STA, AbsoluteY}, {TXS, Implicit}, {TAS, AbsoluteY}, {SHY, AbsoluteX}, {STA, AbsoluteX}, {SHX, AbsoluteY}, {AHX, AbsoluteY},
     {LDY, Immediate}, {LDA, IndirectX}, {LDX, Immediate}, {LAX, IndirectX}, {LDY, ZeroPage}, {LDA, ZeroPage}, {LDX, ZeroPage}, {LAX, ZeroPage}, {TAY, Implicit}, {LDA, Immediate}, {TAX, Implicit}, {LAX, Immediate}, {LDY, Absolute}, {LDA, Absolute}, {LDX, Absolute}, {LAX, Absolute},
-    {BCS, Relative}, {LDA, IndirectY}, {NOP, None}, {LAX, IndirectY}, {LDY, ZeroPageX}, {LDA, ZeroPageX}, {LDX, ZeroPageY}, {LAX, ZeroPageY}, {CLV, Implicit}, {LDA, AbsoluteY}, {TSX, Implicit}, {LAS, AbsoluteY}, {LDY, AbsoluteX}, {LDA, AbsoluteX}, {LDX, AbsoluteY}, {LAX, AbsoluteY},
-    {CPY, Immediate}, {CMP, IndirectX}, {NOP, Immediate}, {DCP, IndirectX}, {CPY, ZeroPage}, {CMP, ZeroPage}, {DEC, ZeroPage}, {DCP, ZeroPage}, {IndirectY, Implicit}, {CMP, Immediate}, {DEX, Implicit}, {AXS, Immediate}, {CPY, Absolute}, {CMP, Absolute}, {DEC, Absolute}, {DCP, Absolute},
-    {BNE, Relative}, {CMP, IndirectY}, {NOP, None}, {DCP, IndirectY}, {NOP, ZeroPageX}, {CMP, ZeroPageX}, {DEC, ZeroPageX}, {DCP, ZeroPageX}, {CLD, Implicit}, {CMP, AbsoluteY}, {NOP, Implicit}, {DCP, AbsoluteY}, {NOP, AbsoluteX}, {CMP, AbsoluteX}, {DEC, AbsoluteX}, {DCP, AbsoluteX},
+    {BCS, Relative}, {LDA, IndirectY}, {KIL, None}, {LAX, IndirectY}, {LDY, ZeroPageX}, {LDA, ZeroPageX}, {LDX, ZeroPageY}, {LAX, ZeroPageY}, {CLV, Implicit}, {LDA, AbsoluteY}, {TSX, Implicit}, {LAS, AbsoluteY}, {LDY, AbsoluteX}, {LDA, AbsoluteX}, {LDX, AbsoluteY}, {LAX, AbsoluteY},
+    {CPY, Immediate}, {CMP, IndirectX}, {NOP, Immediate}, {DCP, IndirectX}, {CPY, ZeroPage}, {CMP, ZeroPage}, {DEC, ZeroPage}, {DCP, ZeroPage}, {INY, Implicit}, {CMP, Immediate}, {DEX, Implicit}, {AXS, Immediate}, {CPY, Absolute}, {CMP, Absolute}, {DEC, Absolute}, {DCP, Absolute},
+    {BNE, Relative}, {CMP, IndirectY}, {KIL, None}, {DCP, IndirectY}, {NOP, ZeroPageX}, {CMP, ZeroPageX}, {DEC, ZeroPageX}, {DCP, ZeroPageX}, {CLD, Implicit}, {CMP, AbsoluteY}, {NOP, Implicit}, {DCP, AbsoluteY}, {NOP, AbsoluteX}, {CMP, AbsoluteX}, {DEC, AbsoluteX}, {DCP, AbsoluteX},
     {CPX, Immediate}, {SBC, IndirectX}, {NOP, Immediate}, {ISC, IndirectX}, {CPX, ZeroPage}, {SBC, ZeroPage}, {INC, ZeroPage}, {ISC, ZeroPage}, {INX, Implicit}, {SBC, Immediate}, {NOP, Implicit}, {SBC, Immediate}, {CPX, Absolute}, {SBC, Absolute}, {INC, Absolute}, {ISC, Absolute},
-    {BEQ, Relative}, {SBC, IndirectY}, {NOP, None}, {ISC, IndirectY}, {NOP, ZeroPageX}, {SBC, ZeroPageX}, {INC, ZeroPageX}, {ISC, ZeroPageX}, {SED, Implicit}, {SBC, AbsoluteY}, {NOP, Immediate}, {ISC, AbsoluteY}, {NOP, AbsoluteX}, {SBC, AbsoluteX}, {INC, AbsoluteX}, {ISC, AbsoluteX}
-}
+    {BEQ, Relative}, {SBC, IndirectY}, {KIL, None}, {ISC, IndirectY}, {NOP, ZeroPageX}, {SBC, ZeroPageX}, {INC, ZeroPageX}, {ISC, ZeroPageX}, {SED, Implicit}, {SBC, AbsoluteY}, {NOP, Implicit}, {ISC, AbsoluteY}, {NOP, AbsoluteX}, {SBC, AbsoluteX}, {INC, AbsoluteX}, {ISC, AbsoluteX}
+};
 
 const uint8_t InstructionCycles[256] = {
 // HI/LO 0  1  2  3  4  5  6  7  8  9  A  B  C  D  E  F
@@ -170,7 +176,7 @@ const uint8_t InstructionCycles[256] = {
  * 7 different flags for CPU flag to display current status
  * */
 typedef enum {
-    Carry = 0,
+    Carry = 1,
     Zero = 1 << 1,
     Interrupt = 1 << 2,
     Decimal = 1 << 3,
@@ -193,7 +199,7 @@ typedef struct {
     uint8_t YIndex;     // Used for several addressing modes.
     // Other
     uint8_t Flag;   // Represented as 7 different flags to show the status of the processor
-    ProcessorFlag StackPointer;   // Holds the address to the current location on the stack
+    uint8_t StackPointer;   // Holds the address to the current location on the stack
     uint16_t ProgramCounter;    // Keeps track of the memory address of the next instruction to be executed
 } Registers;
 
@@ -203,17 +209,24 @@ typedef struct {
     Registers registers;
     struct Bus *bus;
     uint64_t cycles;    // Cycle counter
-    uint8_t current_value;      // Current opcode
+    uint8_t current_opcode;     // Current opcode
+    uint16_t current_address;   // Address the current instruction operates on
+    AddressingMode mode;    // Addressing mode of the current instruction
+    bool page_crossed;      // Whether indexing the current address crossed a page
+    uint64_t unimplemented;     // Instructions executed that are not emulated (KIL, AHX, TAS, XAA)
 } CPU;
 
 
 void CpuInit(CPU *cpu);
 void CpuWrite(CPU *cpu, uint16_t address, uint8_t value);    // Write memory
 uint8_t CpuRead(CPU *cpu, uint16_t address);     // Read memory
+uint8_t CpuReadOperand(CPU *cpu);     // Read the value the current instruction operates on
 void CpuConnectToBus(CPU *cpu, Bus *bus);    // Connect CPU to bus
 void CpuReset(CPU *cpu);
 void CpuStep(CPU *cpu);    // Perform one clock cycle and execute an instruction
-void CpuNmi(CPU *cpu);     // Non maskable interrupt 
+void CpuNmi(CPU *cpu);     // Non maskable interrupt
+void CpuPush(CPU *cpu, uint8_t value);     // Push a byte onto the stack
+uint8_t CpuPull(CPU *cpu);     // Pull a byte from the stack
     
 // Addressing modes functions
 void IMP(CPU *cpu);     // Implicit
@@ -231,62 +244,79 @@ void IDX(CPU *cpu);     // Indirect X
 void IDY(CPU *cpu);     // Indirect Y
 
 
+// Opcodes functions, prefixed with Op so they do not clash with Opcode
+void OpADC(CPU *cpu);     // Add with carry
+void OpAND(CPU *cpu);     // Logical And (And With Accumulator)
+void OpASL(CPU *cpu);     // Arithmetic Shift Left
+void OpBCC(CPU *cpu);     // Branch if Carry Clear
+void OpBCS(CPU *cpu);     // Branch if Carry Set
+void OpBEQ(CPU *cpu);     // Branch if Equal
+void OpBIT(CPU *cpu);     // Bit Test
+void OpBMI(CPU *cpu);     // Branch if Minus
+void OpBNE(CPU *cpu);     // Branch if Not Equal
+void OpBPL(CPU *cpu);     // Branch if Positive
+void OpBRK(CPU *cpu);     // Force Interrupt
+void OpBVC(CPU *cpu);     // Branch if Overflow Clear
+void OpBVS(CPU *cpu);     // Branch if Overflow Set
+void OpCLC(CPU *cpu);     // Clear Carry Flag
+void OpCLD(CPU *cpu);     // Clear Decimal Mode
+void OpCLI(CPU *cpu);     // Clear Interrupt Disable
+void OpCLV(CPU *cpu);     // Clear Overflow Flag
+void OpCMP(CPU *cpu);     // Compare
+void OpCPX(CPU *cpu);     // Compare X Register
+void OpCPY(CPU *cpu);     // Compare Y Register
+void OpDEC(CPU *cpu);     // Decrement Memory
+void OpDEX(CPU *cpu);     // Decrement X Register
+void OpDEY(CPU *cpu);     // Decrement Y Register
+void OpEOR(CPU *cpu);     // Exclusive OR
+void OpINC(CPU *cpu);     // Increment Memory
+void OpINX(CPU *cpu);     // Increment X Register
+void OpINY(CPU *cpu);     // Increment Y Register
+void OpJMP(CPU *cpu);     // Jump
+void OpJSR(CPU *cpu);     // Jump to Subroutine
+void OpLDA(CPU *cpu);     // Load Accumulator
+void OpLDX(CPU *cpu);     // Load X Register
+void OpLDY(CPU *cpu);     // Load Y Register
+void OpLSR(CPU *cpu);     // Logical Shift Right
+void OpNOP(CPU *cpu);     // No Operation
+void OpORA(CPU *cpu);     // Logical Inclusive Or
+void OpPHA(CPU *cpu);     // Push Accumulator
+void OpPHP(CPU *cpu);     // Push Processor Status
+void OpPLA(CPU *cpu);     // Pull Accumulator
+void OpPLP(CPU *cpu);     // Pull Processor Status
+void OpROL(CPU *cpu);     // Rotate Left
+void OpROR(CPU *cpu);     // Rotate Right
+void OpRTI(CPU *cpu);     // Return from Interrupt
+void OpRTS(CPU *cpu);     // Return from Subroutine
+void OpSBC(CPU *cpu);     // Subtract with Carry
+void OpSEC(CPU *cpu);     // Set Carry Flag
+void OpSED(CPU *cpu);     // Set Decimal Flag
+void OpSEI(CPU *cpu);     // Set Interrupt Flag
+void OpSTA(CPU *cpu);     // Store Accumulator
+void OpSTX(CPU *cpu);     // Store X Register
+void OpSTY(CPU *cpu);     // Store Y Register
+void OpTAX(CPU *cpu);     // Transfer Accumulator to X
+void OpTAY(CPU *cpu);     // Transfer Accumulator to Y
+void OpTSX(CPU *cpu);     // Transfer Stack Pointer to X
+void OpTXA(CPU *cpu);     // Transfer X to Accumulator
+void OpTXS(CPU *cpu);     // Transfer X to Stack Pointer
+void OpTYA(CPU *cpu);     // Transfer X to Accumulators
 
-void ADC();     // Add with carry
-void AND();     // Logical And (And With Accumulator)
-void ASL();     // Arithmetic Shift Left
-void BCC();     // Branch if Carry Clear
-void BCS();     // Branch if Carry Set
-void BEQ();     // Branch if Equal
-void BIT();     // Bit Test
-void BMI();     // Branch if Minus
-void BNE();     // Branch if Not Equal
-void BPL();     // Branch if Positive
-void BRK();     // Force Interrupt
-void BVC();     // Branch if Overflow Clear
-void BVS();     // Branch if Overflow Set
-void CLC();     // Clear Carry Flag
-void CLD();     // Clear Decimal Mode
-void CLI();     // Clear Interrupt Disable
-void CLV();     // Clear Overflow Flag
-void CMP();     // Compare
-void CPX();     // Compare X Register
-void CPY();     // Compare Y Register
-void DEC();     // Decrement Memory
-void DEX();     // Decrement X Register
-void DEY();     // Decrement Y Register
-void EOR();     // Exclusive OR
-void INC();     // Increment Memory
-void INX();     // Increment X Register
-void INY();     // Increment Y Register
-void JMP();     // Jump
-void JSR();     // Jump to Subroutine
-void LDA();     // Load Accumulator
-void LDX();     // Load X Register
-void LDY();     // Load Y Register
-void LSR();     // Logical Shift Right
-void NOP();     // No Operation
-void ORA();     // Logical Inclusive Or
-void PHA();     // Push Accumulator
-void PHP();     // Push Processor Status
-void PLA();     // Pull Accumulator
-void PLP();     // Pull Processor Status
-void ROL();     // Rotate Left
-void ROR();     // Rotate Right
-void RTI();     // Return from Interrupt
-void RTS();     // Return from Subroutine
-void SBC();     // Subtract with Carry
-void SEC();     // Set Carry Flag
-void SED();     // Set Decimal Flag
-void SEI();     // Set Interrupt Flag
-void STA();     // Store Accumulator
-void STX();     // Store X Register
-void STY();     // Store Y Register
-void TAX();     // Transfer Accumulator to X
-void TAY();     // Transfer Accumulator to Y
-void TSX();     // Transfer Stack Pointer to X
-void TXA();     // Transfer X to Accumulator
-void TXS();     // Transfer X to Stack Pointer
-void TYA();     // Transfer X to Accumulators
+// Unofficial opcodes functions
+void OpALR(CPU *cpu);     // AND then Logical Shift Right
+void OpANC(CPU *cpu);     // AND then copy Negative to Carry
+void OpARR(CPU *cpu);     // AND then Rotate Right
+void OpAXS(CPU *cpu);     // X = (A AND X) - value
+void OpLAX(CPU *cpu);     // Load Accumulator and X Register
+void OpLAS(CPU *cpu);     // A, X and Stack Pointer = value AND Stack Pointer
+void OpSAX(CPU *cpu);     // Store A AND X
+void OpSHY(CPU *cpu);     // Store Y AND (high byte of address + 1)
+void OpSHX(CPU *cpu);     // Store X AND (high byte of address + 1)
+void OpDCP(CPU *cpu);     // Decrement Memory then Compare
+void OpISC(CPU *cpu);     // Increment Memory then Subtract with Carry
+void OpRLA(CPU *cpu);     // Rotate Left then AND
+void OpRRA(CPU *cpu);     // Rotate Right then Add with Carry
+void OpSLO(CPU *cpu);     // Arithmetic Shift Left then OR
+void OpSRE(CPU *cpu);     // Logical Shift Right then Exclusive OR
 
 #endif
\ No newline at end of file
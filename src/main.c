@@ -0,0 +1,95 @@
+/*
+ * Headless runner, runs a rom for a number of frames without any video or audio output.
+ * Prints the throughput as JSON so it can be tracked per commit.
+ *
+ * Usage: nes <rom> [--frames n] [--pc address] [--min-fps fps] [--profile-csv path] [--profile-json path]
+ * */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bus.h"
+#include "cartridge.h"
+#include "profiler.h"
+
+static Bus bus;
+
+static double Seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void Usage() {
+    fprintf(stderr, "Usage: nes <rom> [--frames n] [--pc address] [--min-fps fps] [--profile-csv path] [--profile-json path]\n");
+}
+
+int main(int argc, char **argv) {
+    const char *rom = NULL;
+    const char *profile_csv = NULL;
+    const char *profile_json = NULL;
+    long frames = 600;
+    long pc = -1;   // Start address, -1 to use the reset vector
+    double min_fps = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--pc") == 0 && i + 1 < argc) {
+            pc = strtol(argv[++i], NULL, 16);
+        } else if (strcmp(argv[i], "--min-fps") == 0 && i + 1 < argc) {
+            min_fps = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--profile-csv") == 0 && i + 1 < argc) {
+            profile_csv = argv[++i];
+        } else if (strcmp(argv[i], "--profile-json") == 0 && i + 1 < argc) {
+            profile_json = argv[++i];
+        } else if (argv[i][0] != '-' && rom == NULL) {
+            rom = argv[i];
+        } else {
+            Usage();
+            return 2;
+        }
+    }
+    if (rom == NULL || frames <= 0) {
+        Usage();
+        return 2;
+    }
+#ifndef NES_PROFILE
+    if (profile_csv != NULL || profile_json != NULL) {
+        fprintf(stderr, "--profile-csv and --profile-json need the profiler, configure with -DNES_PROFILE=ON\n");
+        return 2;
+    }
+#endif
+
+    BusInit(&bus);
+    if (!CartridgeLoad(&bus, rom)) {
+        fprintf(stderr, "Could not load %s (only iNES mapper 0 is supported)\n", rom);
+        return 1;
+    }
+    CpuReset(&bus.cpu);
+    if (pc >= 0) {
+        bus.cpu.registers.ProgramCounter = (uint16_t)pc;
+    }
+
+    PROFILER_INIT(profile_csv, profile_json);
+
+    double start = Seconds();
+    for (long frame = 0; frame < frames; frame++) {
+        BusRunFrame(&bus);
+    }
+    double elapsed = Seconds() - start;
+    double fps = frames / elapsed;
+
+    // Only the CPU is emulated so far, fps does not include PPU or APU work yet
+    printf("{\"rom\": \"%s\", \"frames\": %ld, \"cycles\": %llu, \"seconds\": %.6f, \"fps\": %.2f, "
+           "\"emulated\": [\"cpu\"], \"unimplemented_instructions\": %llu}\n",
+           rom, frames, (unsigned long long)bus.cpu.cycles, elapsed, fps, (unsigned long long)bus.cpu.unimplemented);
+
+    if (fps < min_fps) {
+        fprintf(stderr, "%.2f fps is below the floor of %.2f fps\n", fps, min_fps);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,205 @@
+/*
+ * The profiler is used to find out where emulation time goes for a given rom.
+ * Results are exported as CSV and/or JSON when the program exits.
+ * */
+
+#ifdef NES_PROFILE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "profiler.h"
+#include "cpu.h"
+
+Profiler profiler;
+
+// Names for every value of Opcode, in the same order as the enum
+static const char *OpcodeNames[] = {
+    "ADC", "AND", "ASL", "BCC", "BCS", "BEQ", "BIT", "BMI", "BNE", "BPL", "BRK", "BVC", "BVS", "CLC",
+    "CLD", "CLI", "CLV", "CMP", "CPX", "CPY", "DEC", "DEX", "DEY", "EOR", "INC", "INX", "INY", "JMP",
+    "JSR", "LDA", "LDX", "LDY", "LSR", "NOP", "ORA", "PHA", "PHP", "PLA", "PLP", "ROL", "ROR", "RTI",
+    "RTS", "SBC", "SEC", "SED", "SEI", "STA", "STX", "STY", "TAX", "TAY", "TSX", "TXA", "TXS", "TYA",
+
+    // Unofficial opcodes
+    "ALR", "ANC", "ARR", "AXS", "LAX", "LAS", "SAX", "SHY", "SHX",
+    "DCP", "ISC", "RLA", "RRA", "SLO", "SRE",
+    "SKB", "IGN",
+
+    // Unstable or halting opcodes that are not emulated
+    "KIL", "AHX", "TAS", "XAA",
+};
+
+static const char *SubsystemNames[ProfileSubsystemCount] = {"cpu", "ppu", "apu", "output"};
+
+// Monotonic wall time in nanoseconds
+static uint64_t ProfilerNow() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+static const char *ProfilerOpcodeName(int slot) {
+    unsigned int opcode = OpcodeMatrix[slot].opcode;
+    if (opcode < sizeof(OpcodeNames) / sizeof(OpcodeNames[0])) {
+        return OpcodeNames[opcode];
+    }
+    return "???";
+}
+
+// Upper bound (exclusive, in us) of a histogram bucket
+static uint64_t ProfilerBucketLimit(int bucket) {
+    return 1ull << bucket;
+}
+
+// Write the results to every export path given to ProfilerInit
+static void ProfilerExport() {
+    if (profiler.csv_path != NULL) {
+        ProfilerExportCsv(profiler.csv_path);
+    }
+    if (profiler.json_path != NULL) {
+        ProfilerExportJson(profiler.json_path);
+    }
+}
+
+// Reset all counters and export the results when the program exits
+void ProfilerInit(const char *csv_path, const char *json_path) {
+    static bool registered = false;
+
+    memset(&profiler, 0, sizeof(profiler));
+    profiler.csv_path = csv_path;
+    profiler.json_path = json_path;
+
+    if (!registered) {
+        atexit(ProfilerExport);
+        registered = true;
+    }
+}
+
+void ProfilerBegin(ProfilerSubsystem subsystem) {
+    profiler.section_start[subsystem] = ProfilerNow();
+    profiler.frame_measured[subsystem] = true;
+}
+
+void ProfilerEnd(ProfilerSubsystem subsystem) {
+    profiler.frame_time[subsystem] += ProfilerNow() - profiler.section_start[subsystem];
+}
+
+// Add the time each subsystem timed this frame took to its histogram and start a new frame
+void ProfilerEndFrame() {
+    for (int subsystem = 0; subsystem < ProfileSubsystemCount; subsystem++) {
+        // Subsystems that were never timed this frame are left out instead of counted as 0us
+        if (!profiler.frame_measured[subsystem]) {
+            continue;
+        }
+
+        uint64_t us = profiler.frame_time[subsystem] / 1000;
+        int bucket = 0;
+        while (bucket < PROFILER_HISTOGRAM_BUCKETS - 1 && us >= ProfilerBucketLimit(bucket)) {
+            bucket++;
+        }
+
+        profiler.histogram[subsystem][bucket]++;
+        profiler.total_time[subsystem] += profiler.frame_time[subsystem];
+        profiler.frame_time[subsystem] = 0;
+        profiler.frame_measured[subsystem] = false;
+        profiler.measured_frames[subsystem]++;
+    }
+    profiler.frames++;
+}
+
+// One row per non zero counter: category,key,name,value
+void ProfilerExportCsv(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        return;
+    }
+
+    fprintf(file, "category,key,name,value\n");
+    fprintf(file, "frames,,,%llu\n", (unsigned long long)profiler.frames);
+    for (int slot = 0; slot < 256; slot++) {
+        if (profiler.opcode_count[slot] > 0) {
+            const char *name = ProfilerOpcodeName(slot);
+            fprintf(file, "opcode_count,0x%02X,%s,%llu\n", slot, name, (unsigned long long)profiler.opcode_count[slot]);
+            fprintf(file, "opcode_cycles,0x%02X,%s,%llu\n", slot, name, (unsigned long long)profiler.opcode_cycles[slot]);
+        }
+    }
+    for (int page = 0; page < 256; page++) {
+        if (profiler.page_reads[page] > 0) {
+            fprintf(file, "bus_read,0x%02X00,,%llu\n", page, (unsigned long long)profiler.page_reads[page]);
+        }
+        if (profiler.page_writes[page] > 0) {
+            fprintf(file, "bus_write,0x%02X00,,%llu\n", page, (unsigned long long)profiler.page_writes[page]);
+        }
+    }
+    for (int subsystem = 0; subsystem < ProfileSubsystemCount; subsystem++) {
+        if (profiler.measured_frames[subsystem] == 0) {
+            continue;
+        }
+
+        const char *name = SubsystemNames[subsystem];
+        fprintf(file, "measured_frames,,%s,%llu\n", name, (unsigned long long)profiler.measured_frames[subsystem]);
+        fprintf(file, "total_time_us,,%s,%llu\n", name, (unsigned long long)(profiler.total_time[subsystem] / 1000));
+        for (int bucket = 0; bucket < PROFILER_HISTOGRAM_BUCKETS; bucket++) {
+            if (profiler.histogram[subsystem][bucket] > 0) {
+                fprintf(file, "frame_time_us_lt,%llu,%s,%llu\n", (unsigned long long)ProfilerBucketLimit(bucket),
+                        name, (unsigned long long)profiler.histogram[subsystem][bucket]);
+            }
+        }
+    }
+
+    fclose(file);
+}
+
+static void ProfilerWriteJsonArray(FILE *file, const uint64_t *values, int length) {
+    fprintf(file, "[");
+    for (int i = 0; i < length; i++) {
+        fprintf(file, "%s%llu", i > 0 ? "," : "", (unsigned long long)values[i]);
+    }
+    fprintf(file, "]");
+}
+
+void ProfilerExportJson(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        return;
+    }
+
+    fprintf(file, "{\n  \"frames\": %llu,\n  \"opcodes\": [", (unsigned long long)profiler.frames);
+    bool first = true;
+    for (int slot = 0; slot < 256; slot++) {
+        if (profiler.opcode_count[slot] > 0) {
+            fprintf(file, "%s\n    {\"slot\": %d, \"name\": \"%s\", \"count\": %llu, \"cycles\": %llu}",
+                    first ? "" : ",", slot, ProfilerOpcodeName(slot),
+                    (unsigned long long)profiler.opcode_count[slot], (unsigned long long)profiler.opcode_cycles[slot]);
+            first = false;
+        }
+    }
+
+    fprintf(file, "\n  ],\n  \"bus\": {\n    \"page_reads\": ");
+    ProfilerWriteJsonArray(file, profiler.page_reads, 256);
+    fprintf(file, ",\n    \"page_writes\": ");
+    ProfilerWriteJsonArray(file, profiler.page_writes, 256);
+
+    fprintf(file, "\n  },\n  \"frame_time\": {\n    \"histogram_bucket_limits_us\": [");
+    for (int bucket = 0; bucket < PROFILER_HISTOGRAM_BUCKETS; bucket++) {
+        fprintf(file, "%s%llu", bucket > 0 ? "," : "", (unsigned long long)ProfilerBucketLimit(bucket));
+    }
+    fprintf(file, "]");
+    for (int subsystem = 0; subsystem < ProfileSubsystemCount; subsystem++) {
+        if (profiler.measured_frames[subsystem] == 0) {
+            continue;
+        }
+
+        fprintf(file, ",\n    \"%s\": {\"frames\": %llu, \"total_us\": %llu, \"histogram\": ", SubsystemNames[subsystem],
+                (unsigned long long)profiler.measured_frames[subsystem], (unsigned long long)(profiler.total_time[subsystem] / 1000));
+        ProfilerWriteJsonArray(file, profiler.histogram[subsystem], PROFILER_HISTOGRAM_BUCKETS);
+        fprintf(file, "}");
+    }
+    fprintf(file, "\n  }\n}\n");
+
+    fclose(file);
+}
+
+#endif
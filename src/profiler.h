@@ -0,0 +1,81 @@
+/*
+ * The profiler is used to find out where emulation time goes for a given rom.
+ * It counts executions and cycles per opcode slot, bus reads/writes per 256 byte page and
+ * records wall time histograms per subsystem per frame.
+ *
+ * The profiler is only compiled in when NES_PROFILE is defined. Otherwise every hook expands to nothing.
+ * */
+
+#pragma once
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+// Subsystems timed once per frame
+typedef enum {
+    ProfileCpu,
+    ProfilePpu,
+    ProfileApu,
+    ProfileOutput,
+    ProfileSubsystemCount
+} ProfilerSubsystem;
+
+// Bucket 0 holds frames under 1us, bucket n holds frames in [2^(n-1), 2^n) us and the last bucket holds the rest
+#define PROFILER_HISTOGRAM_BUCKETS 24
+
+typedef struct {
+    // Hot path counters
+    uint64_t opcode_count[256];     // Executions per OpcodeMatrix slot
+    uint64_t opcode_cycles[256];    // Cycles spent per OpcodeMatrix slot
+    uint64_t page_reads[256];   // Bus reads per 256 byte page
+    uint64_t page_writes[256];  // Bus writes per 256 byte page
+
+    // Frame timing
+    uint64_t frames;
+    uint64_t section_start[ProfileSubsystemCount];  // Start time (ns) of the section currently running
+    uint64_t frame_time[ProfileSubsystemCount];     // Time (ns) spent so far in the current frame
+    bool frame_measured[ProfileSubsystemCount];     // Whether the subsystem was timed in the current frame
+    uint64_t measured_frames[ProfileSubsystemCount];    // Frames the subsystem was timed in
+    uint64_t total_time[ProfileSubsystemCount];     // Time (ns) spent over all frames
+    uint64_t histogram[ProfileSubsystemCount][PROFILER_HISTOGRAM_BUCKETS];
+
+    // Export paths used at exit, NULL to skip
+    const char *csv_path;
+    const char *json_path;
+} Profiler;
+
+#ifdef NES_PROFILE
+
+extern Profiler profiler;
+
+void ProfilerInit(const char *csv_path, const char *json_path);     // Reset counters and export at exit
+void ProfilerBegin(ProfilerSubsystem subsystem);    // Start timing a subsystem
+void ProfilerEnd(ProfilerSubsystem subsystem);      // Stop timing a subsystem
+void ProfilerEndFrame();    // Add the current frame to the histograms
+void ProfilerExportCsv(const char *path);
+void ProfilerExportJson(const char *path);
+
+#define PROFILER_INIT(csv_path, json_path) ProfilerInit((csv_path), (json_path))
+#define PROFILE_OPCODE(slot, cycles) \
+    do { profiler.opcode_count[(slot)]++; profiler.opcode_cycles[(slot)] += (cycles); } while (0)
+#define PROFILE_BUS_READ(address) (profiler.page_reads[(uint16_t)(address) >> 8]++)
+#define PROFILE_BUS_WRITE(address) (profiler.page_writes[(uint16_t)(address) >> 8]++)
+#define PROFILE_BEGIN(subsystem) ProfilerBegin(subsystem)
+#define PROFILE_END(subsystem) ProfilerEnd(subsystem)
+#define PROFILE_END_FRAME() ProfilerEndFrame()
+
+#else
+
+#define PROFILER_INIT(csv_path, json_path) ((void)0)
+// sizeof keeps the arguments referenced without evaluating them
+#define PROFILE_OPCODE(slot, cycles) ((void)sizeof(cycles))
+#define PROFILE_BUS_READ(address) ((void)0)
+#define PROFILE_BUS_WRITE(address) ((void)0)
+#define PROFILE_BEGIN(subsystem) ((void)0)
+#define PROFILE_END(subsystem) ((void)0)
+#define PROFILE_END_FRAME() ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,150 @@
+/*
+ * Conformance checks against freely available test roms.
+ *
+ * nestest: runs the rom in automation mode (from 0xC000) and compares the registers and cycles
+ * before every instruction with the matching line of nestest.log.
+ * https://www.nesdev.org/wiki/Emulator_tests
+ *
+ * blargg: runs the rom until it writes its result to 0x6000. 0x6001-0x6003 hold DE B0 61 once the
+ * result is valid, 0x6000 is 0x80 while running, 0x81 when it needs a reset and otherwise the result
+ * code (0 is a pass). The text output starts at 0x6004.
+ *
+ * Usage: nes_rom_test nestest <rom> <log>
+ *        nes_rom_test blargg <rom> [max frames]
+ * */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bus.h"
+#include "cartridge.h"
+
+static Bus bus;
+
+// Read the hex value after "name:" in a nestest.log line, -1 if it is missing
+static long LogField(const char *line, const char *name, int base) {
+    char key[8];
+    snprintf(key, sizeof(key), " %s:", name);
+    const char *field = strstr(line, key);
+    if (field == NULL) {
+        return -1;
+    }
+    return strtol(field + strlen(key), NULL, base);
+}
+
+static int RunNestest(const char *rom, const char *log_path) {
+    FILE *log = fopen(log_path, "r");
+    if (log == NULL) {
+        fprintf(stderr, "Could not open %s\n", log_path);
+        return 1;
+    }
+
+    BusInit(&bus);
+    if (!CartridgeLoad(&bus, rom)) {
+        fprintf(stderr, "Could not load %s\n", rom);
+        fclose(log);
+        return 1;
+    }
+    CpuReset(&bus.cpu);
+    bus.cpu.registers.ProgramCounter = 0xC000;  // Automation mode
+
+    char line[256];
+    long line_number = 0;
+    while (fgets(line, sizeof(line), log) != NULL) {
+        line_number++;
+        Registers *registers = &bus.cpu.registers;
+
+        long expected[] = {
+            strtol(line, NULL, 16), LogField(line, "A", 16), LogField(line, "X", 16),
+            LogField(line, "Y", 16), LogField(line, "P", 16), LogField(line, "SP", 16),
+        };
+        long actual[] = {
+            registers->ProgramCounter, registers->Accumulator, registers->XIndex,
+            registers->YIndex, registers->Flag, registers->StackPointer,
+        };
+        const char *names[] = {"PC", "A", "X", "Y", "P", "SP"};
+
+        for (int i = 0; i < 6; i++) {
+            if (expected[i] != actual[i]) {
+                fprintf(stderr, "nestest.log line %ld: %s is %02lX, expected %02lX\n%s", line_number, names[i], actual[i], expected[i], line);
+                fclose(log);
+                return 1;
+            }
+        }
+
+        // Logs with a "PPU:" column count CPU cycles in CYC, older ones count PPU dots and are skipped
+        if (strstr(line, " PPU:") != NULL) {
+            long cycles = LogField(line, "CYC", 10);
+            if (cycles >= 0 && (uint64_t)cycles != bus.cpu.cycles) {
+                fprintf(stderr, "nestest.log line %ld: CYC is %llu, expected %ld\n%s", line_number,
+                        (unsigned long long)bus.cpu.cycles, cycles, line);
+                fclose(log);
+                return 1;
+            }
+        }
+
+        CpuStep(&bus.cpu);
+    }
+    fclose(log);
+
+    // nestest also stores an error code for the official and unofficial opcodes in 0x02 and 0x03
+    if (bus.ram[0x0002] != 0x00 || bus.ram[0x0003] != 0x00) {
+        fprintf(stderr, "nestest reported errors %02X %02X\n", bus.ram[0x0002], bus.ram[0x0003]);
+        return 1;
+    }
+    printf("nestest: %ld instructions match\n", line_number);
+    return 0;
+}
+
+static bool BlarggHasResult() {
+    return bus.ram[0x6001] == 0xDE && bus.ram[0x6002] == 0xB0 && bus.ram[0x6003] == 0x61;
+}
+
+static int RunBlargg(const char *rom, long max_frames) {
+    BusInit(&bus);
+    if (!CartridgeLoad(&bus, rom)) {
+        fprintf(stderr, "Could not load %s (only iNES mapper 0 is supported)\n", rom);
+        return 1;
+    }
+    CpuReset(&bus.cpu);
+
+    for (long frame = 0; frame < max_frames; frame++) {
+        BusRunFrame(&bus);
+        if (!BlarggHasResult() || bus.ram[0x6000] == 0x80) {
+            continue;
+        }
+        if (bus.ram[0x6000] == 0x81) {
+            // The test asks for a reset, which it expects at least 100ms later
+            for (int delay = 0; delay < 6; delay++) {
+                BusRunFrame(&bus);
+            }
+            CpuReset(&bus.cpu);
+            continue;
+        }
+
+        // The text output is null terminated and stays inside the 0x6000-0x7FFF cartridge ram
+        const char *text = (const char *)&bus.ram[0x6004];
+        printf("%.*s\n", (int)strnlen(text, 0x8000 - 0x6004), text);
+        if (bus.ram[0x6000] != 0x00) {
+            fprintf(stderr, "%s failed with result %d\n", rom, bus.ram[0x6000]);
+            return 1;
+        }
+        return 0;
+    }
+
+    fprintf(stderr, "%s did not report a result within %ld frames\n", rom, max_frames);
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc == 4 && strcmp(argv[1], "nestest") == 0) {
+        return RunNestest(argv[2], argv[3]);
+    }
+    if ((argc == 3 || argc == 4) && strcmp(argv[1], "blargg") == 0) {
+        return RunBlargg(argv[2], argc == 4 ? strtol(argv[3], NULL, 10) : 60 * 60);
+    }
+
+    fprintf(stderr, "Usage: nes_rom_test nestest <rom> <log>\n       nes_rom_test blargg <rom> [max frames]\n");
+    return 2;
+}
@@ -0,0 +1,34 @@
+/*
+ * Small helpers shared by the tests.
+ * Every test is its own program that returns non zero when a check fails, so CTest can run it directly.
+ * */
+
+#pragma once
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+
+static int test_failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#define CHECK_EQUAL(actual, expected) \
+    do { \
+        unsigned long long actual_value = (unsigned long long)(actual); \
+        unsigned long long expected_value = (unsigned long long)(expected); \
+        if (actual_value != expected_value) { \
+            fprintf(stderr, "%s:%d: %s is 0x%llX, expected 0x%llX\n", __FILE__, __LINE__, #actual, actual_value, expected_value); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#define TEST_RESULT() (test_failures == 0 ? 0 : 1)
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * CartridgeLoad tests, each one writes a small iNES file and loads it into a bus.
+ * */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "bus.h"
+#include "cartridge.h"
+#include "test.h"
+
+#define PRG_BANK_SIZE (1024 * 16)
+#define CHR_BANK_SIZE (1024 * 8)
+
+static Bus bus;
+static uint8_t prg[PRG_BANK_SIZE * 2];
+
+// Write an iNES file whose PRG rom bytes are the low byte of their offset, with bank n starting at n
+static void WriteRom(const char *path, const char *magic, uint8_t prg_banks, uint8_t flags6, uint8_t flags7, size_t prg_written) {
+    uint8_t header[16] = {0};
+    memcpy(header, magic, 4);
+    header[4] = prg_banks;
+    header[5] = 1;
+    header[6] = flags6;
+    header[7] = flags7;
+
+    for (size_t i = 0; i < sizeof(prg); i++) {
+        prg[i] = (uint8_t)(i + i / PRG_BANK_SIZE);
+    }
+
+    FILE *file = fopen(path, "wb");
+    fwrite(header, 1, sizeof(header), file);
+    if (flags6 & 0x04) {
+        uint8_t trainer[512];
+        memset(trainer, 0xEE, sizeof(trainer));
+        fwrite(trainer, 1, sizeof(trainer), file);
+    }
+    fwrite(prg, 1, prg_written, file);
+    if (prg_written == prg_banks * (size_t)PRG_BANK_SIZE) {
+        static uint8_t chr[CHR_BANK_SIZE];
+        fwrite(chr, 1, sizeof(chr), file);
+    }
+    fclose(file);
+}
+
+// A single 16kb bank is mirrored into 0xC000
+static void TestSingleBank() {
+    WriteRom("test_cartridge_16k.nes", "NES\x1A", 1, 0x00, 0x00, PRG_BANK_SIZE);
+    BusInit(&bus);
+
+    CHECK(CartridgeLoad(&bus, "test_cartridge_16k.nes"));
+    CHECK(memcmp(&bus.ram[0x8000], prg, PRG_BANK_SIZE) == 0);
+    CHECK(memcmp(&bus.ram[0xC000], prg, PRG_BANK_SIZE) == 0);
+    remove("test_cartridge_16k.nes");
+}
+
+static void TestTwoBanks() {
+    WriteRom("test_cartridge_32k.nes", "NES\x1A", 2, 0x00, 0x00, PRG_BANK_SIZE * 2);
+    BusInit(&bus);
+
+    CHECK(CartridgeLoad(&bus, "test_cartridge_32k.nes"));
+    CHECK(memcmp(&bus.ram[0x8000], prg, PRG_BANK_SIZE * 2) == 0);
+    remove("test_cartridge_32k.nes");
+}
+
+static void TestTrainerSkipped() {
+    WriteRom("test_cartridge_trainer.nes", "NES\x1A", 1, 0x04, 0x00, PRG_BANK_SIZE);
+    BusInit(&bus);
+
+    CHECK(CartridgeLoad(&bus, "test_cartridge_trainer.nes"));
+    CHECK_EQUAL(bus.ram[0x8000], prg[0]);
+    CHECK(memcmp(&bus.ram[0x8000], prg, PRG_BANK_SIZE) == 0);
+    remove("test_cartridge_trainer.nes");
+}
+
+static void TestRejected() {
+    BusInit(&bus);
+    CHECK(!CartridgeLoad(&bus, "test_cartridge_missing.nes"));
+
+    WriteRom("test_cartridge_magic.nes", "NEZ\x1A", 1, 0x00, 0x00, PRG_BANK_SIZE);
+    CHECK(!CartridgeLoad(&bus, "test_cartridge_magic.nes"));
+    remove("test_cartridge_magic.nes");
+
+    // Mapper 1 (MMC1)
+    WriteRom("test_cartridge_mapper.nes", "NES\x1A", 1, 0x10, 0x00, PRG_BANK_SIZE);
+    CHECK(!CartridgeLoad(&bus, "test_cartridge_mapper.nes"));
+    remove("test_cartridge_mapper.nes");
+
+    WriteRom("test_cartridge_truncated.nes", "NES\x1A", 2, 0x00, 0x00, PRG_BANK_SIZE);
+    CHECK(!CartridgeLoad(&bus, "test_cartridge_truncated.nes"));
+    remove("test_cartridge_truncated.nes");
+}
+
+int main() {
+    TestSingleBank();
+    TestTwoBanks();
+    TestTrainerSkipped();
+    TestRejected();
+    return TEST_RESULT();
+}
@@ -0,0 +1,191 @@
+/*
+ * CPU tests, each one runs a small program from 0x8000 and checks the registers, memory and cycles.
+ * */
+
+#include <stdint.h>
+#include <string.h>
+#include "bus.h"
+#include "cpu.h"
+#include "test.h"
+
+static Bus bus;
+
+// Load a program at 0x8000, point the reset vector at it and reset the CPU
+static void Load(const uint8_t *code, size_t length) {
+    BusInit(&bus);
+    memcpy(&bus.ram[0x8000], code, length);
+    bus.ram[0xFFFC] = 0x00;
+    bus.ram[0xFFFD] = 0x80;
+    CpuReset(&bus.cpu);
+}
+
+static void Step(int instructions) {
+    for (int i = 0; i < instructions; i++) {
+        CpuStep(&bus.cpu);
+    }
+}
+
+static void TestReset() {
+    const uint8_t code[] = {0xEA};
+    Load(code, sizeof(code));
+
+    CHECK_EQUAL(bus.cpu.registers.ProgramCounter, 0x8000);
+    CHECK_EQUAL(bus.cpu.registers.StackPointer, 0xFD);
+    CHECK_EQUAL(bus.cpu.registers.Flag, 0x24);  // Interrupt and Unused
+    CHECK_EQUAL(bus.cpu.cycles, 7);
+}
+
+// LDA #$42; LDX #5; loop: DEX; BNE loop; STA $0200; JMP $8000
+static void TestLoop() {
+    const uint8_t code[] = {0xA9, 0x42, 0xA2, 0x05, 0xCA, 0xD0, 0xFD, 0x8D, 0x00, 0x02, 0x4C, 0x00, 0x80};
+    Load(code, sizeof(code));
+
+    Step(2 + 5 * 2 + 2);
+    CHECK_EQUAL(bus.cpu.registers.Accumulator, 0x42);
+    CHECK_EQUAL(bus.cpu.registers.XIndex, 0x00);
+    CHECK_EQUAL(bus.ram[0x0200], 0x42);
+    CHECK_EQUAL(bus.cpu.registers.ProgramCounter, 0x8000);
+    CHECK(bus.cpu.registers.Flag & Zero);
+    // 2 + 2, 5 DEX, 4 taken and 1 not taken BNE, 4 + 3, after the 7 reset cycles
+    CHECK_EQUAL(bus.cpu.cycles, 7 + 4 + 5 * 2 + 4 * 3 + 2 + 4 + 3);
+    CHECK_EQUAL(bus.cpu.unimplemented, 0);
+}
+
+static void TestAddWithCarry() {
+    // CLC; LDA #$50; ADC #$50
+    const uint8_t add[] = {0x18, 0xA9, 0x50, 0x69, 0x50};
+    Load(add, sizeof(add));
+    Step(3);
+    CHECK_EQUAL(bus.cpu.registers.Accumulator, 0xA0);
+    CHECK(bus.cpu.registers.Flag & Overflow);
+    CHECK(bus.cpu.registers.Flag & Negative);
+    CHECK(!(bus.cpu.registers.Flag & Carry));
+
+    // SEC; LDA #$00; SBC #$01
+    const uint8_t subtract[] = {0x38, 0xA9, 0x00, 0xE9, 0x01};
+    Load(subtract, sizeof(subtract));
+    Step(3);
+    CHECK_EQUAL(bus.cpu.registers.Accumulator, 0xFF);
+    CHECK(!(bus.cpu.registers.Flag & Carry));
+    CHECK(!(bus.cpu.registers.Flag & Overflow));
+    CHECK(bus.cpu.registers.Flag & Negative);
+}
+
+// JSR $8010 ... $8010: RTS
+static void TestSubroutine() {
+    uint8_t code[0x11] = {0x20, 0x10, 0x80};
+    code[0x10] = 0x60;
+    Load(code, sizeof(code));
+
+    Step(1);
+    CHECK_EQUAL(bus.cpu.registers.ProgramCounter, 0x8010);
+    CHECK_EQUAL(bus.cpu.registers.StackPointer, 0xFB);
+    CHECK_EQUAL(bus.ram[0x01FD], 0x80);
+    CHECK_EQUAL(bus.ram[0x01FC], 0x02);
+
+    Step(1);
+    CHECK_EQUAL(bus.cpu.registers.ProgramCounter, 0x8003);
+    CHECK_EQUAL(bus.cpu.registers.StackPointer, 0xFD);
+}
+
+// PHP pushes Break and Unused, PLP ignores Break
+static void TestStatusStack() {
+    // SEC; PHP; CLC; PLP
+    const uint8_t code[] = {0x38, 0x08, 0x18, 0x28};
+    Load(code, sizeof(code));
+
+    Step(2);
+    CHECK_EQUAL(bus.ram[0x01FD], 0x24 | Carry | Break);
+    Step(2);
+    CHECK_EQUAL(bus.cpu.registers.Flag, 0x24 | Carry);
+}
+
+// BRK jumps through 0xFFFE and RTI returns past its padding byte
+static void TestInterrupt() {
+    uint8_t code[0x21] = {0x00, 0xEA, 0xEA};
+    code[0x20] = 0x40;
+    Load(code, sizeof(code));
+    bus.ram[0xFFFE] = 0x20;
+    bus.ram[0xFFFF] = 0x80;
+    bus.cpu.registers.Flag &= ~Interrupt;
+
+    Step(1);
+    CHECK_EQUAL(bus.cpu.registers.ProgramCounter, 0x8020);
+    CHECK(bus.cpu.registers.Flag & Interrupt);
+    CHECK_EQUAL(bus.ram[0x01FB], 0x20 | Break);
+
+    Step(1);
+    CHECK_EQUAL(bus.cpu.registers.ProgramCounter, 0x8002);
+    CHECK(!(bus.cpu.registers.Flag & Interrupt));
+}
+
+// Indexed reads that cross a page take one more cycle, stores do not
+static void TestPageCrossing() {
+    // LDX #1; LDA $02FF,X; STA $02FF,X
+    const uint8_t code[] = {0xA2, 0x01, 0xBD, 0xFF, 0x02, 0x9D, 0xFF, 0x02};
+    Load(code, sizeof(code));
+    bus.ram[0x0300] = 0x99;
+
+    Step(1);
+    uint64_t cycles = bus.cpu.cycles;
+    Step(1);
+    CHECK_EQUAL(bus.cpu.registers.Accumulator, 0x99);
+    CHECK_EQUAL(bus.cpu.cycles - cycles, 5);
+
+    cycles = bus.cpu.cycles;
+    Step(1);
+    CHECK_EQUAL(bus.cpu.cycles - cycles, 5);
+}
+
+// JMP ($02FF) reads the high byte from $0200, not $0300
+static void TestIndirectJumpBug() {
+    const uint8_t code[] = {0x6C, 0xFF, 0x02};
+    Load(code, sizeof(code));
+    bus.ram[0x02FF] = 0x34;
+    bus.ram[0x0200] = 0x12;
+    bus.ram[0x0300] = 0x56;
+
+    Step(1);
+    CHECK_EQUAL(bus.cpu.registers.ProgramCounter, 0x1234);
+}
+
+// ASL A uses the accumulator, DCP decrements memory then compares
+static void TestReadModifyWrite() {
+    // LDA #$81; ASL A; LDA #$10; DCP $10
+    const uint8_t code[] = {0xA9, 0x81, 0x0A, 0xA9, 0x10, 0xC7, 0x10};
+    Load(code, sizeof(code));
+    bus.ram[0x0010] = 0x11;
+
+    Step(2);
+    CHECK_EQUAL(bus.cpu.registers.Accumulator, 0x02);
+    CHECK(bus.cpu.registers.Flag & Carry);
+    CHECK_EQUAL(bus.cpu.registers.ProgramCounter, 0x8003);
+
+    Step(2);
+    CHECK_EQUAL(bus.ram[0x0010], 0x10);
+    CHECK(bus.cpu.registers.Flag & Zero);
+    CHECK(bus.cpu.registers.Flag & Carry);
+}
+
+static void TestUnimplemented() {
+    // KIL
+    const uint8_t code[] = {0x02};
+    Load(code, sizeof(code));
+
+    Step(1);
+    CHECK_EQUAL(bus.cpu.unimplemented, 1);
+}
+
+int main() {
+    TestReset();
+    TestLoop();
+    TestAddWithCarry();
+    TestSubroutine();
+    TestStatusStack();
+    TestInterrupt();
+    TestPageCrossing();
+    TestIndirectJumpBug();
+    TestReadModifyWrite();
+    TestUnimplemented();
+    return TEST_RESULT();
+}
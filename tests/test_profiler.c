@@ -0,0 +1,85 @@
+/*
+ * Profiler tests, runs a small program for a few frames and checks the CSV and JSON exports.
+ * Built against a copy of the library compiled with NES_PROFILE.
+ * */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bus.h"
+#include "profiler.h"
+#include "test.h"
+
+static Bus bus;
+
+static char *ReadFile(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *text = (char *)calloc(length + 1, 1);
+    fread(text, 1, length, file);
+    fclose(file);
+    return text;
+}
+
+int main() {
+    // LDA #$42; STA $0200; JMP $8000
+    const uint8_t code[] = {0xA9, 0x42, 0x8D, 0x00, 0x02, 0x4C, 0x00, 0x80};
+    BusInit(&bus);
+    memcpy(&bus.ram[0x8000], code, sizeof(code));
+    bus.ram[0xFFFC] = 0x00;
+    bus.ram[0xFFFD] = 0x80;
+    CpuReset(&bus.cpu);
+
+    ProfilerInit(NULL, NULL);
+    for (int frame = 0; frame < 3; frame++) {
+        BusRunFrame(&bus);
+    }
+
+    CHECK_EQUAL(profiler.frames, 3);
+    CHECK_EQUAL(profiler.measured_frames[ProfileCpu], 3);
+    CHECK_EQUAL(profiler.measured_frames[ProfilePpu], 0);
+    CHECK_EQUAL(profiler.opcode_count[0x8D], profiler.opcode_count[0xA9]);
+    CHECK_EQUAL(profiler.opcode_cycles[0x8D], profiler.opcode_count[0x8D] * 4);
+    // STA writes its target without reading it
+    CHECK_EQUAL(profiler.page_writes[0x02], profiler.opcode_count[0x8D]);
+    CHECK_EQUAL(profiler.page_reads[0x02], 0);
+
+    ProfilerExportCsv("test_profiler.csv");
+    char *csv = ReadFile("test_profiler.csv");
+    CHECK(csv != NULL);
+    if (csv != NULL) {
+        CHECK(strncmp(csv, "category,key,name,value\n", 24) == 0);
+        CHECK(strstr(csv, "frames,,,3\n") != NULL);
+        CHECK(strstr(csv, "opcode_count,0x8D,STA,") != NULL);
+        CHECK(strstr(csv, "bus_write,0x0200,,") != NULL);
+        CHECK(strstr(csv, "bus_read,0x0200,,") == NULL);
+        CHECK(strstr(csv, "measured_frames,,cpu,3\n") != NULL);
+        // Subsystems that were never timed are left out
+        CHECK(strstr(csv, ",ppu,") == NULL);
+        CHECK(strstr(csv, ",apu,") == NULL);
+        CHECK(strstr(csv, ",output,") == NULL);
+        free(csv);
+    }
+    remove("test_profiler.csv");
+
+    ProfilerExportJson("test_profiler.json");
+    char *json = ReadFile("test_profiler.json");
+    CHECK(json != NULL);
+    if (json != NULL) {
+        CHECK(strstr(json, "\"frames\": 3,") != NULL);
+        CHECK(strstr(json, "\"name\": \"STA\"") != NULL);
+        CHECK(strstr(json, "\"cpu\": {\"frames\": 3,") != NULL);
+        CHECK(strstr(json, "\"ppu\"") == NULL);
+        free(json);
+    }
+    remove("test_profiler.json");
+
+    return TEST_RESULT();
+}